@@ -16,6 +16,7 @@
 
 #include <iostream>
 #include <vector>
+#include <array>
 #include <set>
 #include <string>
 #include <sstream>
@@ -23,15 +24,93 @@
 #include <iomanip>  //Se incluye para formateo (setw, left).
 #include <chrono>
 #include <regex>
+#include <cstdint>
+#include <unordered_map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SEMIGRUPO_SIMD_X86 1
+#endif
 
 using namespace std;
 
 /**
- * @brief Convierte un vector de generadores en su notacin de semigrupo.
+ * @brief Nmero de generadores que un ConjuntoGeneradores guarda sin memoria dinmica.
+ */
+const int GENERADORES_EN_LINEA = 32;
+
+/**
+ * @brief Conjunto ordenado de generadores con capacidad en lnea.
+ * @details
+ * Hasta GENERADORES_EN_LINEA generadores se guardan en un array de 16 bits dentro del
+ * propio valor, as que crearlo o copiarlo en los bucles internos no reserva memoria;
+ * si hay ms, todos pasan a `desbordados`. Los valores son positivos, menores que
+ * 65536, distintos y crecientes. Se construye implcitamente desde un vector<int>
+ * (en cualquier orden; los repetidos y los no positivos se descartan), de modo que
+ * las funciones que lo reciben siguen aceptando vectores.
+ */
+struct ConjuntoGeneradores {
+   uint16_t enLinea[GENERADORES_EN_LINEA] = {};  //Generadores, si caben.
+   vector<uint16_t> desbordados;                 //Todos los generadores, si no caben.
+   int tamano = 0;                               //Nmero de generadores.
+
+   ConjuntoGeneradores() {}
+   ConjuntoGeneradores(const vector<int>& S);
+
+   const uint16_t* begin() const { return tamano <= GENERADORES_EN_LINEA ? enLinea : desbordados.data(); }
+   const uint16_t* end() const { return begin() + tamano; }
+   size_t size() const { return tamano; }
+   bool empty() const { return tamano == 0; }
+   int operator[](size_t i) const { return begin()[i]; }
+   int front() const { return begin()[0]; }
+   int back() const { return begin()[tamano - 1]; }
+};
+
+/**
+ * @brief Aade un generador mayor que todos los del conjunto.
+ * @param[in,out] G Conjunto.
+ * @param[in] x Nuevo generador.
+ */
+void anadeGenerador(ConjuntoGeneradores& G, int x) {
+   if (G.tamano < GENERADORES_EN_LINEA) {
+      G.enLinea[G.tamano] = (uint16_t)x;
+   } else {
+      if (G.tamano == GENERADORES_EN_LINEA)
+         G.desbordados.assign(G.enLinea, G.enLinea + GENERADORES_EN_LINEA);
+      G.desbordados.push_back((uint16_t)x);
+   }
+   G.tamano++;
+}
+
+/**
+ * @brief Inserta un generador en su posicin, si no estaba ya.
+ * @param[in,out] G Conjunto.
+ * @param[in] x Generador positivo.
+ */
+void insertaGenerador(ConjuntoGeneradores& G, int x) {
+   size_t posicion = lower_bound(G.begin(), G.end(), x) - G.begin();
+   if (posicion < G.size() && G[posicion] == x)
+      return;
+   anadeGenerador(G, x);
+   uint16_t* datos = G.tamano <= GENERADORES_EN_LINEA ? G.enLinea : G.desbordados.data();
+   rotate(datos + posicion, datos + G.tamano - 1, datos + G.tamano);
+}
+
+ConjuntoGeneradores::ConjuntoGeneradores(const vector<int>& S) {
+   for (int s : S)
+      if (s > 0)
+         insertaGenerador(*this, s);
+}
+
+/**
+ * @brief Convierte un conjunto de generadores en su notacin de semigrupo.
  * @param[in] generadores Conjunto de generadores del semigrupo.
  * @return Cadena con el semigrupo en notacin angular.
  */
-string semigrupoAString(const vector<int>& generadores) {
+string semigrupoAString(const ConjuntoGeneradores& generadores) {
    ostringstream oss;
    oss << "<";
    for (size_t i = 0; i < generadores.size(); i++) {
@@ -48,7 +127,7 @@ string semigrupoAString(const vector<int>& generadores) {
  * @param[in] generadores Conjunto de generadores.
  * @return Misma salida que semigrupoAString.
  */
-string corchetesAngulares(const vector<int>& generadores) {
+string corchetesAngulares(const ConjuntoGeneradores& generadores) {
    ostringstream oss;
    oss << "<";
    for (size_t i = 0; i < generadores.size(); i++) {
@@ -60,72 +139,425 @@ string corchetesAngulares(const vector<int>& generadores) {
    return oss.str();
 }
 
+/**
+ * @brief Conjunto de enteros de [0, 64PALABRAS) guardado como bits de ancho fijo.
+ * @details
+ * El ancho se fija al compilar, as que los bucles sobre las palabras se desenrollan y
+ * el conjunto vive en la pila sin reservas de memoria.
+ */
+template <int PALABRAS>
+struct BitsFijos {
+   array<uint64_t, PALABRAS> bloques;
+};
+
+/**
+ * @brief Comprueba si i (0 <= i < 64PALABRAS) est en el conjunto.
+ * @param[in] R Conjunto.
+ * @param[in] i Entero de la ventana.
+ * @return true si su bit est a 1.
+ */
+template <int PALABRAS>
+inline bool contieneFijo(const BitsFijos<PALABRAS>& R, int i) {
+   return (R.bloques[i >> 6] >> (i & 63)) & 1;
+}
+
+/**
+ * @brief Hace R |= R << k dentro de la ventana.
+ * @param[in,out] R Conjunto.
+ * @param[in] k Desplazamiento (0 < k < 64PALABRAS).
+ */
+template <int PALABRAS>
+inline void cierraDesplazamientoFijo(BitsFijos<PALABRAS>& R, int k) {
+   int palabras = k >> 6;
+   int bits = k & 63;
+   //De la palabra ms alta a la ms baja para leer los valores previos
+   for (int i = PALABRAS - 1; i >= palabras; i--) {
+      int j = i - palabras;
+      uint64_t valor = R.bloques[j] << bits;
+      if (bits != 0 && j > 0)
+         valor |= R.bloques[j - 1] >> (64 - bits);
+      R.bloques[i] |= valor;
+   }
+}
+
+/**
+ * @brief Versin de esRepresentable sobre una ventana fija de 64PALABRAS bits.
+ * @param[in] valor Entero a verificar (0 <= valor < 64PALABRAS).
+ * @param[in] generadores Conjunto de generadores del semigrupo.
+ * @return true si `valor` pertenece al semigrupo generado.
+ * @details
+ * Cada generador no alcanzable todava cierra la ventana [0, valor] con desplazamientos
+ * dobles R |= R << g, R |= R << 2g, ..., as que cuesta O(log(valor / g)) pasadas de
+ * unas pocas palabras.
+ */
+template <int PALABRAS>
+bool esRepresentableFijo(int valor, const ConjuntoGeneradores& generadores) {
+   BitsFijos<PALABRAS> R;
+   R.bloques.fill(0);
+   R.bloques[0] = 1;
+   for (int g : generadores) {
+      if (g > valor || contieneFijo(R, g))
+         continue;
+      for (int paso = g; paso <= valor; paso *= 2)
+         cierraDesplazamientoFijo(R, paso);
+   }
+   return contieneFijo(R, valor);
+}
+
 /**
  * @brief Comprueba si un valor es representable como combinacin no negativa de generadores.
  * @param[in] valor Entero a verificar.
  * @param[in] generadores Conjunto de generadores del semigrupo.
  * @return true si existe combinacin de enteros >= 0 que sume `valor`; false en caso contrario.
  * @details
- * Utiliza programacin dinmica: dp[i] = true si i es alcanzable. Inicializa dp[0]=true,
- * y para cada i alcanzable, marca dp[i + g] para cada g en generadores.
+ * Si valor < 1024 se usa la menor ventana de bits fija que lo contiene
+ * (esRepresentableFijo). Si no, programacin dinmica: dp[i] = 1 si i es alcanzable;
+ * se inicializa dp[0] = 1 y para cada i alcanzable se marca dp[i + g] para cada g.
  */
-bool esRepresentable(int valor, const vector<int>& generadores) {
+bool esRepresentable(int valor, const ConjuntoGeneradores& generadores) {
    if (valor < 0) 
       return false;
-   vector<bool> dp(valor + 1, false);
-   dp[0] = true;
+   if (valor < 64)
+      return esRepresentableFijo<1>(valor, generadores);
+   if (valor < 128)
+      return esRepresentableFijo<2>(valor, generadores);
+   if (valor < 256)
+      return esRepresentableFijo<4>(valor, generadores);
+   if (valor < 512)
+      return esRepresentableFijo<8>(valor, generadores);
+   if (valor < 1024)
+      return esRepresentableFijo<16>(valor, generadores);
+
+   vector<uint8_t> dp(valor + 1, 0);
+   dp[0] = 1;
    for (int i = 0; i <= valor; i++) {
       if (!dp[i]) continue;
       for (int g : generadores) {
-         if (i + g <= valor) 
-            dp[i + g] = true;
+         if (g > 0 && i + g <= valor) 
+            dp[i + g] = 1;
       }
    }
    return dp[valor];
 }
 
+/**
+ * @brief Suma con saturacin 1 en destino donde origen es no nulo (versin escalar).
+ * @param[in,out] destino Array de contadores.
+ * @param[in] origen Array que indica pertenencia (no nulo = pertenece).
+ * @param[in] n Nmero de posiciones a actualizar.
+ */
+void sumaPertenenciaEscalar(uint8_t* destino, const uint8_t* origen, int n) {
+   for (int i = 0; i < n; i++)
+      if (origen[i] != 0 && destino[i] != 255)
+         destino[i]++;
+}
+
+#ifdef SEMIGRUPO_SIMD_X86
+/**
+ * @brief Versin AVX2 de sumaPertenenciaEscalar (32 contadores por instruccin).
+ */
+__attribute__((target("avx2")))
+void sumaPertenenciaAVX2(uint8_t* destino, const uint8_t* origen, int n) {
+   const __m256i cero = _mm256_setzero_si256();
+   const __m256i uno = _mm256_set1_epi8(1);
+   int i = 0;
+   for (; i + 32 <= n; i += 32) {
+      __m256i d = _mm256_loadu_si256((const __m256i*)(destino + i));
+      __m256i o = _mm256_loadu_si256((const __m256i*)(origen + i));
+      __m256i suma = _mm256_andnot_si256(_mm256_cmpeq_epi8(o, cero), uno);
+      _mm256_storeu_si256((__m256i*)(destino + i), _mm256_adds_epu8(d, suma));
+   }
+   sumaPertenenciaEscalar(destino + i, origen + i, n - i);
+}
+
+/**
+ * @brief Versin AVX-512 de sumaPertenenciaEscalar (64 contadores por instruccin).
+ */
+__attribute__((target("avx512f,avx512bw")))
+void sumaPertenenciaAVX512(uint8_t* destino, const uint8_t* origen, int n) {
+   const __m512i uno = _mm512_set1_epi8(1);
+   int i = 0;
+   for (; i + 64 <= n; i += 64) {
+      __m512i d = _mm512_loadu_si512((const void*)(destino + i));
+      __m512i o = _mm512_loadu_si512((const void*)(origen + i));
+      __mmask64 pertenece = _mm512_test_epi8_mask(o, o);
+      _mm512_storeu_si512((void*)(destino + i), _mm512_mask_adds_epu8(d, pertenece, d, uno));
+   }
+   sumaPertenenciaEscalar(destino + i, origen + i, n - i);
+}
+#endif
+
+/**
+ * @brief Kernel que suma pertenencias a los nmeros de descomposiciones.
+ */
+struct KernelDescomposiciones {
+   void (*suma)(uint8_t*, const uint8_t*, int);  //destino[i] += (origen[i] != 0), con saturacin.
+   const char* nombre;                           //Juego de instrucciones empleado.
+};
+
+KernelDescomposiciones kernelDescomposiciones = { sumaPertenenciaEscalar, "escalar" };
+
+/**
+ * @brief Selecciona el kernel de descomposiciones segn la preferencia y la CPU.
+ * @param[in] preferencia "auto", "escalar", "avx2" o "avx512".
+ * @return true si la preferencia es vlida y la CPU la admite.
+ */
+bool seleccionaKernel(const string& preferencia) {
+   KernelDescomposiciones escalar = { sumaPertenenciaEscalar, "escalar" };
+   if (preferencia == "escalar") {
+      kernelDescomposiciones = escalar;
+      return true;
+   }
+#ifdef SEMIGRUPO_SIMD_X86
+   __builtin_cpu_init();
+   bool tieneAVX512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+   bool tieneAVX2 = __builtin_cpu_supports("avx2");
+   KernelDescomposiciones avx512 = { sumaPertenenciaAVX512, "avx512" };
+   KernelDescomposiciones avx2 = { sumaPertenenciaAVX2, "avx2" };
+   if (preferencia == "avx512" || (preferencia == "auto" && tieneAVX512)) {
+      kernelDescomposiciones = avx512;
+      return tieneAVX512;
+   }
+   if (preferencia == "avx2" || (preferencia == "auto" && tieneAVX2)) {
+      kernelDescomposiciones = avx2;
+      return tieneAVX2;
+   }
+#endif
+   kernelDescomposiciones = escalar;
+   return preferencia == "auto";
+}
+
 /**
  * @brief Reduce un conjunto de generadores eliminando los redundantes.
- * @param[in] generadores Vector inicial de generadores.
- * @return Nuevo vector donde se han eliminado aquellos g que sean representables
+ * @param[in] generadores Conjunto inicial de generadores.
+ * @return Nuevo conjunto donde se han eliminado aquellos g que sean representables
  *         por el resto de generadores.
  * @details
- * Ordena primero los generadores para procesarlos de menor a mayor. Para cada g,
- * lo elimina temporalmente y comprueba si g sigue siendo representable; si no lo es,
- * se conserva en el conjunto mnimo.
+ * Se calcula una sola vez qu valores hasta el mayor generador son representables y,
+ * a partir de ellos, el nmero de descomposiciones d[v] = #{(a, b) : a <= b, a + b = v}
+ * con a, b representables (incluido el 0). Un generador g es minimal si d[g] = 1, es
+ * decir, si su nica descomposicin es 0 + g. Cada actualizacin de d es una pasada
+ * vectorial del kernel seleccionado.
  */
-vector<int> minimizarGeneradores(vector<int> generadores) {
-   sort(generadores.begin(), generadores.end());
-   vector<int> minimal;
-   for (size_t i = 0; i < generadores.size(); i++) {
-      vector<int> otros = generadores;
-      otros.erase(otros.begin() + i);
-      if (!esRepresentable(generadores[i], otros))
-         minimal.push_back(generadores[i]);
+ConjuntoGeneradores minimizarGeneradores(const ConjuntoGeneradores& generadores) {
+   ConjuntoGeneradores minimal;
+   if (generadores.empty())
+      return minimal;
+
+   int n = generadores.back() + 1;
+   vector<uint8_t> elementos(n, 0);
+   vector<uint8_t> descomposiciones(n, 0);
+   elementos[0] = 1;
+   for (int i = 0; i < n; i++) {
+      if (!elementos[i]) continue;
+      for (int g : generadores) {
+         if (i + g < n)
+            elementos[i + g] = 1;
+      }
+   }
+   for (int a = 0; 2 * a < n; a++) {
+      if (elementos[a])
+         kernelDescomposiciones.suma(&descomposiciones[2 * a], &elementos[a], n - 2 * a);
+   }
+   for (int g : generadores) {
+      if (descomposiciones[g] == 1)
+         anadeGenerador(minimal, g);
    }
    return minimal;
 }
 
 /**
- * @brief Verifica la validez del Frobenius de un semigrupo.
- * @param[in] generadores Conjunto de generadores minimizados.
- * @param[in] F Valor de Frobenius a comprobar.
- * @return true si F no es representable pero F+1 s lo es; false en otro caso.
+ * @brief Tamao mnimo de cada bloque que una Arena pide al sistema.
  */
-bool frobeniusValido(const vector<int>& generadores, int F) {
-   return !esRepresentable(F, generadores)
-      &&  esRepresentable(F+1, generadores);
+const size_t BLOQUE_ARENA = 1 << 20;
+
+/**
+ * @brief Si las arenas sirven la memoria (true) o solo la cuentan y delegan en new/delete (false).
+ * @details
+ * Se fija una vez en main (--arena=no) antes de la bsqueda, para comparar los tiempos
+ * con el asignador por defecto midiendo los mismos bytes.
+ */
+bool arenasActivas = true;
+
+/**
+ * @brief Bytes pedidos a todas las arenas ya destruidas.
+ */
+atomic<uint64_t> bytesArenas(0);
+
+/**
+ * @brief Arena montona: reparte memoria de bloques grandes y solo la libera toda a la vez.
+ * @details
+ * Cada hilo de la bsqueda en amplitud tiene dos, una para el nivel que lee y otra para
+ * el que construye; al empezar un nivel se reinicia la arena del nivel anterior al
+ * padre, cuyos candidatos ya se han destruido. Los bloques se conservan al reiniciar,
+ * as que tras los primeros niveles no se vuelve a pedir memoria al sistema. No se
+ * comparte entre hilos.
+ */
+struct Arena {
+   vector<pair<char*, size_t>> bloques;  //Bloques reservados y su tamao.
+   size_t bloque = 0;                    //Bloque en uso.
+   size_t usado = 0;                     //Bytes ocupados del bloque en uso.
+   uint64_t pedidos = 0;                 //Bytes servidos, tambin con las arenas desactivadas.
+
+   Arena() {}
+   Arena(const Arena&) = delete;
+   Arena& operator=(const Arena&) = delete;
+   ~Arena() {
+      bytesArenas += pedidos;
+      for (auto &b : bloques)
+         delete[] b.first;
+   }
+};
+
+/**
+ * @brief Reserva memoria de una arena (alineada a 16 bytes).
+ * @param[in,out] arena Arena.
+ * @param[in] bytes Nmero de bytes.
+ * @return Puntero vlido hasta el siguiente reiniciaArena.
+ */
+void* reservaArena(Arena& arena, size_t bytes) {
+   arena.pedidos += bytes;
+   if (!arenasActivas)
+      return ::operator new(bytes);
+   bytes = (bytes + 15) & ~(size_t)15;
+   while (arena.bloque < arena.bloques.size()) {
+      pair<char*, size_t>& b = arena.bloques[arena.bloque];
+      if (arena.usado + bytes <= b.second) {
+         void* p = b.first + arena.usado;
+         arena.usado += bytes;
+         return p;
+      }
+      arena.bloque++;
+      arena.usado = 0;
+   }
+   size_t tamano = max(BLOQUE_ARENA, bytes);
+   arena.bloques.push_back(make_pair(new char[tamano], tamano));
+   arena.usado = bytes;
+   return arena.bloques.back().first;
+}
+
+/**
+ * @brief Da por libre toda la memoria de una arena, conservando sus bloques.
+ * @param[in,out] arena Arena; nada de lo reservado antes puede seguir en uso.
+ */
+void reiniciaArena(Arena& arena) {
+   arena.bloque = 0;
+   arena.usado = 0;
+}
+
+/**
+ * @brief Asignador para contenedores estndar que toma la memoria de una Arena.
+ * @details
+ * Sin arena (el valor por defecto) equivale a new/delete. Se propaga al mover e
+ * intercambiar contenedores, de modo que un candidato movido de un nivel a otro sigue
+ * en la arena donde se cre; al copiar, el destino conserva la suya.
+ */
+template <class T>
+struct AsignadorArena {
+   typedef T value_type;
+   typedef true_type propagate_on_container_move_assignment;
+   typedef true_type propagate_on_container_swap;
+
+   Arena* arena;
+
+   AsignadorArena() : arena(nullptr) {}
+   explicit AsignadorArena(Arena* a) : arena(a) {}
+   template <class U>
+   AsignadorArena(const AsignadorArena<U>& otro) : arena(otro.arena) {}
+
+   T* allocate(size_t n) {
+      if (arena == nullptr)
+         return static_cast<T*>(::operator new(n * sizeof(T)));
+      return static_cast<T*>(reservaArena(*arena, n * sizeof(T)));
+   }
+   void deallocate(T* p, size_t) {
+      if (arena == nullptr || !arenasActivas)
+         ::operator delete(p);
+   }
+};
+
+template <class T, class U>
+bool operator==(const AsignadorArena<T>& a, const AsignadorArena<U>& b) { return a.arena == b.arena; }
+
+template <class T, class U>
+bool operator!=(const AsignadorArena<T>& a, const AsignadorArena<U>& b) { return a.arena != b.arena; }
+
+/**
+ * @brief Conjunto de Apry indexado por resto, con la memoria de una arena si se indica.
+ */
+typedef vector<int, AsignadorArena<int>> VectorApery;
+
+/**
+ * @brief Aade un generador a un conjunto de Apry con una vuelta del algoritmo round-robin.
+ * @param[in,out] w Conjunto de Apry indexado por resto mdulo n = w.size() (-1 = inalcanzable).
+ * @param[in] a Nuevo generador.
+ * @details
+ * Los restos se dividen en mcd(a, n) ciclos q -> q+a mod n. Cada ciclo se recorre una sola
+ * vez desde su mnimo, relajando w[q+a] = min(w[q+a], w[q]+a). El coste es O(n).
+ */
+void anadeGeneradorApery(VectorApery& w, int a) {
+   int modulo = w.size();
+   int paso = a % modulo;
+   if (paso == 0)
+      return;
+   int d = modulo, resto = paso;
+   while (resto != 0) {
+      int t = d % resto;
+      d = resto;
+      resto = t;
+   }
+   int longitud = modulo / d;
+   for (int p = 0; p < d; p++) {
+      //Se busca el mnimo del ciclo que contiene a p
+      int inicio = -1, q = p;
+      for (int j = 0; j < longitud; j++) {
+         if (w[q] >= 0 && (inicio < 0 || w[q] < w[inicio]))
+            inicio = q;
+         q += paso;
+         if (q >= modulo) q -= modulo;
+      }
+      if (inicio < 0)
+         continue;
+      q = inicio;
+      for (int j = 1; j < longitud; j++) {
+         int siguiente = q + paso;
+         if (siguiente >= modulo) siguiente -= modulo;
+         if (w[siguiente] < 0 || w[q] + a < w[siguiente])
+            w[siguiente] = w[q] + a;
+         q = siguiente;
+      }
+   }
+}
+
+/**
+ * @brief Calcula el conjunto de Apry indexado por resto con el algoritmo round-robin.
+ * @param[in] generadores Conjunto de generadores.
+ * @param[in] modulo Entero n > 0 respecto al que se calcula (por lo general un elemento).
+ * @return Vector w de tamao n donde w[r] es el menor elemento del semigrupo congruente
+ *         con r mdulo n, o -1 si ninguno lo es.
+ * @details
+ * Es el algoritmo round-robin de Bcker y Liptk, un camino mnimo sobre los restos
+ * mdulo n: se parte de w = {0, -1, , -1} y se aade cada generador con
+ * anadeGeneradorApery. El coste es O(kn) en tiempo y O(n) en memoria, con k el nmero
+ * de generadores.
+ */
+VectorApery aperyPorResiduo(const ConjuntoGeneradores& generadores, int modulo) {
+   VectorApery w(modulo, -1);
+   w[0] = 0;
+   for (int a : generadores)
+      anadeGeneradorApery(w, a);
+   return w;
 }
 
 /**
  * @brief Construye el semigrupo inicial S0 = <F+1, F+2, , 2F+1>.
  * @param[in] F Valor de Frobenius.
- * @return Vector de generadores de S0.
+ * @return Generadores de S0.
  */
-vector<int> semigrupoInicial(int F) {
-   vector<int> generadores;
+ConjuntoGeneradores semigrupoInicial(int F) {
+   ConjuntoGeneradores generadores;
    for (int i = F+1; i <= 2*F+1; i++)
-      generadores.push_back(i);
+      anadeGenerador(generadores, i);
    return generadores;
 }
 
@@ -133,77 +565,148 @@ vector<int> semigrupoInicial(int F) {
  * @brief Representa un candidato al agregar un nuevo generador.
  */
 struct Candidato {
-   int x;   //Elemento candidato a aadir.
-   vector<int> semigrupo;  //Semigrupo resultante tras la minimizacin.
+   int x;   //Elemento candidato a aadir (0 en la raz y en los nodos guardados por nivel).
+   ConjuntoGeneradores semigrupo;  //Semigrupo resultante tras la minimizacin.
+   VectorApery apery;              //Ap(semigrupo, F+1) indexado por resto.
 };
 
+/**
+ * @brief Comprueba si un entero pertenece al semigrupo a partir de su conjunto de Apry.
+ * @param[in] w Conjunto de Apry indexado por resto (-1 = inalcanzable).
+ * @param[in] y Entero a comprobar.
+ * @return true si y es mayor o igual que el menor elemento de su clase de resto.
+ */
+bool perteneceApery(const VectorApery& w, int y) {
+   if (y < 0)
+      return false;
+   int minimo = w[y % w.size()];
+   return minimo >= 0 && y >= minimo;
+}
+
+/**
+ * @brief Calcula los huecos especiales de un semigrupo con Frobenius F.
+ * @param[in] S Generadores minimales del semigrupo.
+ * @param[in] apery Ap(S, F+1) indexado por resto.
+ * @param[in] hasta Solo se buscan huecos menores que este valor.
+ * @return Huecos especiales menores que hasta en orden creciente (incluido F si F < hasta).
+ * @details
+ * Un hueco x es pseudo-Frobenius si x + g pertenece a S para todo generador minimal g, y
+ * especial si adems 2x pertenece a S (y entonces tambin 3x). Son exactamente los huecos
+ * para los que S unin {x} vuelve a ser un semigrupo. Como todo hueco es menor que F+1,
+ * x es hueco si y solo si w[x] != x. El coste es O(Fe), con e el nmero de generadores.
+ */
+vector<int> huecosEspeciales(const ConjuntoGeneradores& S, const VectorApery& apery, int hasta) {
+   vector<int> especiales;
+   int cota = min(hasta, (int)apery.size());
+   for (int x = 1; x < cota; x++) {
+      if (apery[x] == x || !perteneceApery(apery, 2 * x))
+         continue;
+      bool pseudoFrobenius = true;
+      for (int g : S) {
+         if (!perteneceApery(apery, x + g)) {
+            pseudoFrobenius = false;
+            break;
+         }
+      }
+      if (pseudoFrobenius)
+         especiales.push_back(x);
+   }
+   return especiales;
+}
+
+/**
+ * @brief Construye el hijo S unin {x} de un semigrupo a partir de sus datos.
+ * @param[in] S Generadores minimales del padre.
+ * @param[in] apery Ap(S, F+1) indexado por resto.
+ * @param[in] x Hueco especial de S distinto de F.
+ * @param[in,out] arena Arena de la que sale el Apry del hijo (nullptr: memoria dinmica).
+ * @return Candidato con x, los generadores minimales del hijo y su Apry.
+ * @details
+ * Se obtiene en O(e) a partir del padre:
+ * - Ap(S unin {x}, F+1) solo cambia en w[x] = x, pues x < F+1.
+ * - x es generador minimal, ya que no es suma de elementos de S.
+ * - Un generador minimal g de S deja de serlo exactamente cuando g - x pertenece al
+ *   hijo, lo que se comprueba en O(1) con w.
+ */
+Candidato hijoConHueco(const ConjuntoGeneradores& S, const VectorApery& apery, int x, Arena* arena) {
+   Candidato c;
+   c.x = x;
+   c.apery = VectorApery(apery, AsignadorArena<int>(arena));
+   c.apery[x] = x;
+   bool colocado = false;
+   for (int g : S) {
+      if (!colocado && x < g) {
+         anadeGenerador(c.semigrupo, x);
+         colocado = true;
+      }
+      if (!perteneceApery(c.apery, g - x))
+         anadeGenerador(c.semigrupo, g);
+   }
+   if (!colocado)
+      anadeGenerador(c.semigrupo, x);
+   return c;
+}
+
 /**
  * @brief Obtiene los candidatos que pueden aadirse manteniendo Frobenius = F.
  * @param[in] S Conjunto actual de generadores minimizados.
+ * @param[in] apery Ap(S, F+1) indexado por resto, como lo devuelve aperyPorResiduo.
  * @param[in] F Valor de Frobenius objetivo.
- * @return Vector de estructuras Candidato con cada posible x y su semigrupo.
+ * @param[in,out] arena Arena para el Apry de los candidatos (nullptr: memoria dinmica).
+ * @return Vector de estructuras Candidato con cada posible x, su semigrupo y su Apry.
+ * @details
+ * Los hijos son S unin {x} para cada hueco especial x distinto de F, as que solo se
+ * construyen extensiones vlidas y todas conservan el Frobenius. Todo semigrupo T con
+ * Frobenius F distinto de S0 se alcanza as (T sin su multiplicidad es un padre), pero
+ * puede tener varios padres.
  */
-vector<Candidato> obtenerCandidatos(const vector<int>& S, int F) {
+vector<Candidato> obtenerCandidatos(const ConjuntoGeneradores& S, const VectorApery& apery, int F, Arena* arena) {
    vector<Candidato> candidatos;
-   int m = S.empty() ? F+1 : S[0];
-   for (int x = 2; x < m; x++) {
+   for (int x : huecosEspeciales(S, apery, F + 1)) {
       if (x == F) 
          continue;
-      vector<int> T = S;
-      if (find(T.begin(), T.end(), x) == T.end()) {
-         T.push_back(x);
-         T = minimizarGeneradores(T);
-         if (frobeniusValido(T, F))
-            candidatos.push_back({x, T});
-      }
+      candidatos.push_back(hijoConHueco(S, apery, x, arena));
    }
    return candidatos;
 }
 
 /**
- * @brief Calcula el conjunto de Apry de un semigrupo respecto a un perodo.
- * @param[in] generadores Conjunto de generadores minimizados.
- * @param[in] periodo     Entero de referencia para el resto (por lo general F+1).
- * @return Vector ordenado de size=periodo con el menor valor representable para cada resto.
+ * @brief Obtiene solo los hijos de los que S es el padre cannico.
+ * @param[in] S Conjunto actual de generadores minimizados.
+ * @param[in] apery Ap(S, F+1) indexado por resto.
+ * @param[in] F Valor de Frobenius objetivo.
+ * @param[in,out] arena Arena para el Apry de los hijos (nullptr: memoria dinmica).
+ * @return Hijos S unin {x} con x hueco especial menor que la multiplicidad de S.
  * @details
- * Emplea programacin dinmica similar a esRepresentable hasta 2periodo para asegurar
- * que cada clase de resto mod periodo aparezca.
- */
-vector<int> conjuntoApery(const vector<int>& generadores, int periodo) {
-   int limite = 2 * periodo * periodo;
-   vector<bool> dp(limite + 1, false);
-   dp[0] = true;
-   for (int i = 0; i <= limite; i++) {
-      if (!dp[i]) continue;
-      for (int g : generadores) {
-         int nx = i + g;
-         if (nx <= limite) 
-            dp[nx] = true;
-      }
-   }
-   vector<int> ap;
-   for (int r = 0; r < periodo; r++) {
-      int candidato = -1;
-      for (int v = 0; v <= limite; v++) {
-         if (dp[v] && v % periodo == r) {
-            candidato = v;
-            break;
-         }
-      }
-      if (candidato >= 0) ap.push_back(candidato);
+ * El padre cannico de T con multiplicidad m < F es T sin {m}. S unin {x} tiene a S como
+ * padre cannico exactamente cuando x es su nueva multiplicidad, es decir, x < m(S). As
+ * cada semigrupo con Frobenius F se genera una sola vez y no hace falta recordar los ya vistos.
+ */
+vector<Candidato> obtenerHijosCanonicos(const ConjuntoGeneradores& S, const VectorApery& apery, int F, Arena* arena) {
+   vector<Candidato> hijos;
+   int m = S.empty() ? F+1 : S[0];
+   for (int x : huecosEspeciales(S, apery, m)) {
+      if (x == F)
+         continue;
+      hijos.push_back(hijoConHueco(S, apery, x, arena));
    }
-   sort(ap.begin(), ap.end());
-   return ap;
+   return hijos;
 }
 
 /**
- * @brief Convierte el conjunto de Apry a cadena.
+ * @brief Convierte a cadena un conjunto de Apry ya calculado.
  * @param[in] generadores Conjunto de generadores.
+ * @param[in] apery       Conjunto de Apry indexado por resto mdulo periodo.
  * @param[in] periodo     Perodo usado en el clculo (F+1).
  * @return Cadena con formato Ap(<generadores>, periodo) = {a0,,a_{periodo-1}}.
  */
-string aperyAString(const vector<int>& generadores, int periodo) {
-   auto ap = conjuntoApery(generadores, periodo);
+string aperyAString(const ConjuntoGeneradores& generadores, const VectorApery& apery, int periodo) {
+   vector<int> ap;
+   for (int v : apery) {
+      if (v >= 0)
+         ap.push_back(v);
+   }
+   sort(ap.begin(), ap.end());
    ostringstream oss;
    oss << "Ap(" << corchetesAngulares(generadores) << ", " << periodo << ") = {";
    for (size_t i = 0; i < ap.size(); i++) {
@@ -220,49 +723,182 @@ string aperyAString(const vector<int>& generadores, int periodo) {
  * @param[in] vistos Conjunto de representaciones en cadena ya mostradas.
  * @return true si semigrupoAString(S) est en vistos.
  */
-bool yaVisto(const vector<int>& S, const set<string>& vistos) {
+bool yaVisto(const ConjuntoGeneradores& S, const set<string>& vistos) {
    return vistos.count( semigrupoAString(S) ) > 0;
 }
 
+/**
+ * @brief Lista compacta de semigrupos en formato CSR (filas comprimidas).
+ * @details
+ *   Los generadores de todos los semigrupos van seguidos en un nico array de 16 bits y
+ *   el semigrupo i ocupa valores[inicios[i]..inicios[i+1]). La clasificacin en hoja o
+ *   interno se guarda en un mapa de bits aparte. Frente a vector<vector<int>> se evita
+ *   una reserva de memoria y 24 bytes de cabecera por semigrupo, y cada valor ocupa la
+ *   mitad. Los generadores deben ser menores que 65536 y el total de valores menor
+ *   que 2^32.
+ */
+struct ListaSemigrupos {
+   vector<uint16_t> valores;                         //Generadores de todos los semigrupos, seguidos.
+   vector<uint32_t> inicios = vector<uint32_t>(1, 0); //Inicio de cada semigrupo y final del ltimo.
+   vector<uint64_t> hojas;                           //Bit i a 1 si el semigrupo i es hoja.
+};
+
+/**
+ * @brief Nmero de semigrupos de una lista.
+ * @param[in] L Lista.
+ * @return Nmero de semigrupos guardados.
+ */
+size_t numSemigrupos(const ListaSemigrupos& L) {
+   return L.inicios.size() - 1;
+}
+
+/**
+ * @brief Aade un semigrupo al final de una lista.
+ * @param[in,out] L Lista.
+ * @param[in] generadores Generadores minimales, en el orden en que se guardarn.
+ * @param[in] tamano Nmero de generadores.
+ * @param[in] hoja Si el semigrupo es hoja.
+ */
+void anadeSemigrupo(ListaSemigrupos& L, const uint16_t* generadores, size_t tamano, bool hoja) {
+   size_t i = numSemigrupos(L);
+   if (i % 64 == 0)
+      L.hojas.push_back(0);
+   if (hoja)
+      L.hojas[i / 64] |= 1ULL << (i % 64);
+   L.valores.insert(L.valores.end(), generadores, generadores + tamano);
+   L.inicios.push_back((uint32_t)L.valores.size());
+}
+
+/**
+ * @brief Aade un semigrupo al final de una lista.
+ * @param[in,out] L Lista.
+ * @param[in] S Generadores minimales.
+ * @param[in] hoja Si el semigrupo es hoja.
+ */
+void anadeSemigrupo(ListaSemigrupos& L, const ConjuntoGeneradores& S, bool hoja) {
+   anadeSemigrupo(L, S.begin(), S.size(), hoja);
+}
+
+/**
+ * @brief Indica si el semigrupo i de la lista es hoja.
+ * @param[in] L Lista.
+ * @param[in] i ndice del semigrupo.
+ * @return true si es hoja.
+ */
+bool esHojaLista(const ListaSemigrupos& L, size_t i) {
+   return (L.hojas[i / 64] >> (i % 64)) & 1;
+}
+
+/**
+ * @brief Nmero de generadores del semigrupo i de la lista.
+ * @param[in] L Lista.
+ * @param[in] i ndice del semigrupo.
+ * @return Tamao de su sistema minimal.
+ */
+size_t tamanoSemigrupo(const ListaSemigrupos& L, size_t i) {
+   return L.inicios[i + 1] - L.inicios[i];
+}
+
+/**
+ * @brief Generadores del semigrupo i de la lista, sin copiarlos.
+ * @param[in] L Lista.
+ * @param[in] i ndice del semigrupo.
+ * @return Puntero a sus tamanoSemigrupo(L, i) generadores.
+ */
+const uint16_t* generadoresSemigrupo(const ListaSemigrupos& L, size_t i) {
+   return L.valores.data() + L.inicios[i];
+}
+
+/**
+ * @brief Cuenta las hojas de una lista.
+ * @param[in] L Lista.
+ * @return Nmero de semigrupos marcados como hoja.
+ */
+uint64_t cuentaHojas(const ListaSemigrupos& L) {
+   uint64_t total = 0;
+   for (uint64_t palabra : L.hojas)
+      total += __builtin_popcountll(palabra);
+   return total;
+}
+
+/**
+ * @brief Imprime, uno por lnea como <a,b,...>, los semigrupos de la lista de una clase.
+ * @param[in] L Lista.
+ * @param[in] hojas true para imprimir las hojas y false para los internos.
+ */
+void imprimeLista(const ListaSemigrupos& L, bool hojas) {
+   for (size_t i = 0; i < numSemigrupos(L); i++) {
+      if (esHojaLista(L, i) != hojas)
+         continue;
+      const uint16_t* g = generadoresSemigrupo(L, i);
+      size_t n = tamanoSemigrupo(L, i);
+      cout << "<";
+      for (size_t j = 0; j < n; j++)
+         cout << g[j] << (j + 1 < n ? "," : "");
+      cout << ">\n";
+   }
+}
+
+/**
+ * @brief Indica si un semigrupo con Frobenius F es hoja (todos sus generadores son menores que F).
+ * @param[in] S Generadores minimales.
+ * @param[in] F Valor de Frobenius.
+ * @return true si es hoja, false si es interno.
+ */
+bool esHojaFrobenius(const ConjuntoGeneradores& S, int F) {
+   for (int g : S) {
+      if (g >= F)
+         return false;
+   }
+   return true;
+}
+
 /**
  * @brief Genera e imprime todos los semigrupos con Frobenius = F en BFS.
  * @param[in] F Valor de Frobenius deseado.
- * @return Vector de todos los semigrupos minimizados encontrados.
+ * @return Lista de todos los semigrupos minimizados encontrados, clasificados en internos y hojas.
  * @details
  * - Inicia con S0 minimizado.
  * - Repite: para cada semigrupo en el nivel actual, genera candidatos, filtra duplicados,
  *   los imprime alineados con su Apry y los aade al siguiente nivel.
+ * - El Apry de los candidatos de cada nivel sale de una de dos arenas alternas.
  */
-vector<vector<int>> generaSemigruposConF(int F) {
+ListaSemigrupos generaSemigruposConF(int F) {
    set<string> vistos;
-   vector<vector<int>> resultado;
+   ListaSemigrupos resultado;
+   Arena arenas[2];
 
    //Semigrupo inicial
-   vector<int> S0 = semigrupoInicial(F);
+   ConjuntoGeneradores S0 = semigrupoInicial(F);
    S0 = minimizarGeneradores(S0);
-   resultado.push_back(S0);
+   anadeSemigrupo(resultado, S0, esHojaFrobenius(S0, F));
    vistos.insert(semigrupoAString(S0) );
 
+   //Cada nodo guarda su Ap(S, F+1) para que los hijos lo actualicen en lugar de recalcularlo
+   Candidato raiz{0, S0, aperyPorResiduo(S0, F+1)};
    string s0_str = semigrupoAString(S0);
-   string s0_apery = aperyAString(S0, F+1);
+   string s0_apery = aperyAString(S0, raiz.apery, F+1);
    cout << left << setw(30) << s0_str << " | " << s0_apery << "\n";
 
-   vector<vector<int>> nivelActual{ S0 };
+   vector<Candidato> nivelActual{ raiz };
 
    //Se hace una bsqueda en amplitud sobre las ramas
-   while (!nivelActual.empty()) {
-      vector<vector<int>> siguienteNivel;
+   for (int nivel = 0; !nivelActual.empty(); nivel++) {
+      //La arena del nivel anterior al de los padres ya no tiene candidatos vivos
+      Arena& arena = arenas[nivel % 2];
+      reiniciaArena(arena);
+      vector<Candidato> siguienteNivel;
       for (auto &S : nivelActual) {
-         auto candidatos = obtenerCandidatos(S, F);
+         auto candidatos = obtenerCandidatos(S.semigrupo, S.apery, F, &arena);
          for (auto &c : candidatos) {
             if (!yaVisto(c.semigrupo, vistos)) {
                vistos.insert( semigrupoAString(c.semigrupo) );
-               resultado.push_back(c.semigrupo);
-               siguienteNivel.push_back(c.semigrupo);
+               anadeSemigrupo(resultado, c.semigrupo, esHojaFrobenius(c.semigrupo, F));
                //Se muestra el semigrupo y el conjunto de Apry en columnas alineadas
                string semigrupoStr = semigrupoAString(c.semigrupo);
-               string aperyStr = aperyAString(c.semigrupo, F+1);
+               string aperyStr = aperyAString(c.semigrupo, c.apery, F+1);
                cout << left << setw(30) << semigrupoStr << " | " << aperyStr << "\n";
+               siguienteNivel.push_back(std::move(c));
             }
          }
       }
@@ -272,11 +908,414 @@ vector<vector<int>> generaSemigruposConF(int F) {
    return resultado;
 }
 
+/**
+ * @brief Clave compacta de un semigrupo: bits de sus generadores minimales.
+ * @details
+ *   El sistema minimal de generadores es nico, as que el bit g de la clave est a 1
+ *   si y solo si g es generador minimal; con F fijo ocupa unas pocas palabras.
+ */
+struct ClaveSemigrupo {
+   vector<uint64_t> bits;
+   bool operator==(const ClaveSemigrupo& otra) const { return bits == otra.bits; }
+};
+
+/**
+ * @brief Funcin hash para ClaveSemigrupo (mezcla multiplicativa de las palabras).
+ */
+struct HashClave {
+   size_t operator()(const ClaveSemigrupo& clave) const {
+      uint64_t h = 0x9E3779B97F4A7C15ULL;
+      for (uint64_t palabra : clave.bits) {
+         h ^= palabra + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+         h *= 0xFF51AFD7ED558CCDULL;
+      }
+      return (size_t)(h ^ (h >> 33));
+   }
+};
+
+/**
+ * @brief Construye la clave compacta de un sistema minimal de generadores.
+ * @param[in] generadores Generadores minimales.
+ * @return Clave con un bit por generador.
+ */
+ClaveSemigrupo claveCompacta(const ConjuntoGeneradores& generadores) {
+   ClaveSemigrupo clave;
+   int maximo = generadores.empty() ? 0 : generadores.back();
+   clave.bits.assign(maximo / 64 + 1, 0);
+   for (int g : generadores)
+      clave.bits[g / 64] |= 1ULL << (g % 64);
+   return clave;
+}
+
+/**
+ * @brief Conjunto hash concurrente, dividido en fragmentos con su propio cerrojo.
+ * @details
+ *   Asocia a cada clave el menor orden de descubrimiento registrado, de modo que el
+ *   resultado no depende del hilo que llegue primero.
+ */
+struct ConjuntoConcurrente {
+   static const int FRAGMENTOS = 64;
+   struct Fragmento {
+      mutex cerrojo;
+      unordered_map<ClaveSemigrupo, uint64_t, HashClave> ordenes;
+   };
+   Fragmento fragmentos[FRAGMENTOS];
+};
+
+/**
+ * @brief Registra una clave con su orden, conservando el menor si ya exista.
+ * @param[in,out] conjunto Conjunto concurrente.
+ * @param[in] clave Clave del semigrupo.
+ * @param[in] orden Orden de descubrimiento.
+ */
+void registraMinimo(ConjuntoConcurrente& conjunto, const ClaveSemigrupo& clave, uint64_t orden) {
+   ConjuntoConcurrente::Fragmento& f = conjunto.fragmentos[HashClave()(clave) % ConjuntoConcurrente::FRAGMENTOS];
+   lock_guard<mutex> bloqueo(f.cerrojo);
+   auto it = f.ordenes.find(clave);
+   if (it == f.ordenes.end())
+      f.ordenes.emplace(clave, orden);
+   else if (orden < it->second)
+      it->second = orden;
+}
+
+/**
+ * @brief Devuelve el menor orden registrado para una clave.
+ * @param[in,out] conjunto Conjunto concurrente.
+ * @param[in] clave Clave ya registrada.
+ * @return Orden de descubrimiento ganador.
+ */
+uint64_t ordenRegistrado(ConjuntoConcurrente& conjunto, const ClaveSemigrupo& clave) {
+   ConjuntoConcurrente::Fragmento& f = conjunto.fragmentos[HashClave()(clave) % ConjuntoConcurrente::FRAGMENTOS];
+   lock_guard<mutex> bloqueo(f.cerrojo);
+   return f.ordenes.at(clave);
+}
+
+/**
+ * @brief Candidato encontrado por un hilo durante un nivel de la bsqueda paralela.
+ */
+struct EntradaNivel {
+   uint64_t orden;                 //(nivel, ndice del padre, ndice del candidato) empaquetados.
+   ClaveSemigrupo clave;           //Clave compacta del semigrupo.
+   ConjuntoGeneradores semigrupo;  //Generadores minimales.
+   VectorApery apery;              //Ap(semigrupo, F+1) indexado por resto.
+   string linea;                   //Lnea a imprimir (solo para los ganadores).
+};
+
+/**
+ * @brief Empaqueta el orden de descubrimiento de la bsqueda en amplitud secuencial.
+ * @param[in] nivel Nivel de la bsqueda.
+ * @param[in] padre ndice del padre dentro de su nivel.
+ * @param[in] candidato ndice del candidato dentro de los de su padre.
+ * @return Entero cuyo orden coincide con el de la bsqueda secuencial.
+ */
+uint64_t codificaOrden(uint64_t nivel, uint64_t padre, uint64_t candidato) {
+   return (nivel << 48) | (padre << 16) | candidato;
+}
+
+/**
+ * @brief Formatea un semigrupo y su conjunto de Apry en columnas alineadas.
+ * @param[in] S Generadores minimales.
+ * @param[in] apery Ap(S, F+1) indexado por resto.
+ * @param[in] F Valor de Frobenius.
+ * @return Lnea de salida sin salto de lnea.
+ */
+string lineaSemigrupo(const ConjuntoGeneradores& S, const VectorApery& apery, int F) {
+   ostringstream oss;
+   oss << left << setw(30) << semigrupoAString(S) << " | " << aperyAString(S, apery, F+1);
+   return oss.str();
+}
+
+/**
+ * @brief Genera e imprime todos los semigrupos con Frobenius = F en BFS repartiendo cada nivel entre hilos.
+ * @param[in] F Valor de Frobenius deseado.
+ * @param[in] hilos Nmero de hilos.
+ * @return Lista de todos los semigrupos minimizados encontrados, en el mismo orden que la versin secuencial.
+ * @details
+ * Cada nivel se procesa en dos fases paralelas con el nivel dividido en bloques contiguos
+ * entre a lo sumo tantos hilos como padres tiene (con un solo padre no se lanza ningn hilo):
+ * - Fase 1: cada hilo genera los candidatos de sus padres en un bfer propio y registra
+ *   su clave compacta en el conjunto concurrente con su orden de descubrimiento.
+ * - Fase 2: cada hilo se queda con las entradas cuyo orden es el mnimo registrado
+ *   (las que la versin secuencial habra aceptado) y prepara su lnea de salida.
+ * Despus, las entradas ganadoras se ordenan y se imprimen en un solo hilo. Cada hilo
+ * toma el Apry de sus candidatos de su propio par de arenas alternas.
+ */
+ListaSemigrupos generaSemigruposConFParalelo(int F, int hilos) {
+   ConjuntoConcurrente vistos;
+   ListaSemigrupos resultado;
+   vector<Arena> arenas(2 * hilos);  //Arenas 2t y 2t+1 del hilo t, alternando por niveles.
+
+   ConjuntoGeneradores S0 = minimizarGeneradores(semigrupoInicial(F));
+   Candidato raiz{0, S0, aperyPorResiduo(S0, F+1)};
+   anadeSemigrupo(resultado, S0, esHojaFrobenius(S0, F));
+   registraMinimo(vistos, claveCompacta(S0), codificaOrden(0, 0, 0));
+   cout << lineaSemigrupo(S0, raiz.apery, F) << "\n";
+
+   vector<Candidato> nivelActual{ raiz };
+   uint64_t nivel = 1;
+   while (!nivelActual.empty()) {
+      int usados = min(hilos, (int)nivelActual.size());
+      vector<vector<EntradaNivel>> buffers(usados);
+      size_t bloque = (nivelActual.size() + usados - 1) / usados;
+
+      auto genera = [&](int t) {
+         Arena& arena = arenas[2 * t + nivel % 2];
+         reiniciaArena(arena);
+         size_t inicio = min(nivelActual.size(), t * bloque);
+         size_t fin = min(nivelActual.size(), inicio + bloque);
+         for (size_t p = inicio; p < fin; p++) {
+            auto candidatos = obtenerCandidatos(nivelActual[p].semigrupo, nivelActual[p].apery, F, &arena);
+            for (size_t j = 0; j < candidatos.size(); j++) {
+               EntradaNivel e;
+               e.orden = codificaOrden(nivel, p, j);
+               e.clave = claveCompacta(candidatos[j].semigrupo);
+               e.semigrupo = std::move(candidatos[j].semigrupo);
+               e.apery.swap(candidatos[j].apery);
+               registraMinimo(vistos, e.clave, e.orden);
+               buffers[t].push_back(std::move(e));
+            }
+         }
+      };
+      auto filtra = [&](int t) {
+         vector<EntradaNivel> ganadores;
+         for (auto &e : buffers[t]) {
+            if (ordenRegistrado(vistos, e.clave) == e.orden) {
+               e.linea = lineaSemigrupo(e.semigrupo, e.apery, F);
+               ganadores.push_back(std::move(e));
+            }
+         }
+         buffers[t].swap(ganadores);
+      };
+      if (usados == 1) {
+         genera(0);
+         filtra(0);
+      } else {
+         vector<thread> trabajadores;
+         for (int t = 0; t < usados; t++)
+            trabajadores.push_back(thread(genera, t));
+         for (auto &h : trabajadores)
+            h.join();
+         trabajadores.clear();
+
+         for (int t = 0; t < usados; t++)
+            trabajadores.push_back(thread(filtra, t));
+         for (auto &h : trabajadores)
+            h.join();
+      }
+
+      vector<EntradaNivel> nuevos;
+      for (auto &b : buffers)
+         for (auto &e : b)
+            nuevos.push_back(std::move(e));
+      sort(nuevos.begin(), nuevos.end(), [](const EntradaNivel& a, const EntradaNivel& b) {
+         return a.orden < b.orden;
+      });
+
+      vector<Candidato> siguienteNivel;
+      for (auto &e : nuevos) {
+         cout << e.linea << "\n";
+         anadeSemigrupo(resultado, e.semigrupo, esHojaFrobenius(e.semigrupo, F));
+         siguienteNivel.push_back(Candidato{0, std::move(e.semigrupo), std::move(e.apery)});
+      }
+      nivelActual.swap(siguienteNivel);
+      nivel++;
+   }
+
+   return resultado;
+}
+
+/**
+ * @brief Genera e imprime todos los semigrupos con Frobenius = F recorriendo el rbol de padres cannicos.
+ * @param[in] F Valor de Frobenius deseado.
+ * @param[in] hilos Nmero de hilos.
+ * @return Lista de todos los semigrupos minimizados encontrados, en orden de recorrido.
+ * @details
+ * Recorrido en amplitud en el que cada semigrupo solo genera los hijos de los que es
+ * padre cannico (obtenerHijosCanonicos). No hay duplicados, as que no se guarda ningn
+ * conjunto de vistos y la memoria del recorrido es la de la frontera. Cada nivel se reparte
+ * en bloques contiguos entre los hilos y los bloques se imprimen en orden, de modo que la
+ * salida no depende del nmero de hilos. Como en generaSemigruposConFParalelo, cada hilo
+ * tiene dos arenas alternas para el Apry de los hijos.
+ */
+ListaSemigrupos generaSemigruposConFCanonico(int F, int hilos) {
+   ListaSemigrupos resultado;
+   vector<Arena> arenas(2 * max(hilos, 1));  //Arenas 2t y 2t+1 del hilo t, alternando por niveles.
+
+   ConjuntoGeneradores S0 = minimizarGeneradores(semigrupoInicial(F));
+   Candidato raiz{0, S0, aperyPorResiduo(S0, F+1)};
+   anadeSemigrupo(resultado, S0, esHojaFrobenius(S0, F));
+   cout << lineaSemigrupo(raiz.semigrupo, raiz.apery, F) << "\n";
+
+   vector<Candidato> nivelActual{ raiz };
+   for (int nivel = 0; !nivelActual.empty(); nivel++) {
+      int usados = max(1, min(hilos, (int)nivelActual.size()));
+      vector<vector<Candidato>> buffers(usados);
+      vector<vector<string>> lineas(usados);
+      size_t bloque = (nivelActual.size() + usados - 1) / usados;
+
+      auto procesa = [&](int t) {
+         Arena& arena = arenas[2 * t + nivel % 2];
+         reiniciaArena(arena);
+         size_t inicio = min(nivelActual.size(), t * bloque);
+         size_t fin = min(nivelActual.size(), inicio + bloque);
+         for (size_t p = inicio; p < fin; p++) {
+            for (auto &c : obtenerHijosCanonicos(nivelActual[p].semigrupo, nivelActual[p].apery, F, &arena)) {
+               lineas[t].push_back(lineaSemigrupo(c.semigrupo, c.apery, F));
+               buffers[t].push_back(std::move(c));
+            }
+         }
+      };
+      if (usados == 1) {
+         procesa(0);
+      } else {
+         vector<thread> trabajadores;
+         for (int t = 0; t < usados; t++)
+            trabajadores.push_back(thread(procesa, t));
+         for (auto &h : trabajadores)
+            h.join();
+      }
+
+      vector<Candidato> siguienteNivel;
+      for (int t = 0; t < usados; t++) {
+         for (size_t i = 0; i < buffers[t].size(); i++) {
+            cout << lineas[t][i] << "\n";
+            const ConjuntoGeneradores& S = buffers[t][i].semigrupo;
+            anadeSemigrupo(resultado, S, esHojaFrobenius(S, F));
+            siguienteNivel.push_back(std::move(buffers[t][i]));
+         }
+      }
+      nivelActual.swap(siguienteNivel);
+   }
+
+   return resultado;
+}
+
+/**
+ * @brief Marco de la pila del recorrido en profundidad: un semigrupo y sus hijos pendientes.
+ */
+struct MarcoPila {
+   Candidato nodo;          //Semigrupo con su Ap(S, F+1).
+   vector<int> huecos;      //Huecos especiales menores que la multiplicidad.
+   size_t siguiente;        //ndice del siguiente hueco a expandir.
+};
+
+/**
+ * @brief Recuento de semigrupos internos y hojas.
+ */
+struct RecuentoFrobenius {
+   uint64_t internos = 0;
+   uint64_t hojas = 0;
+};
+
+/**
+ * @brief Genera e imprime en profundidad todos los semigrupos con Frobenius = F, clasificndolos al vuelo.
+ * @param[in] F Valor de Frobenius deseado.
+ * @param[in] imprime Si se imprime cada semigrupo; con false solo se cuentan, sin
+ *            formatear generadores ni conjuntos de Apry.
+ * @return Nmero de semigrupos internos y hojas.
+ * @details
+ * Recorre en preorden el rbol de padres cannicos con una pila explcita. Cada marco
+ * guarda un semigrupo, su Apry y sus huecos especiales cannicos, y los hijos se
+ * construyen de uno en uno al desapilar. La profundidad es a lo sumo F (cada nivel
+ * aade un elemento menor que F), as que la memoria es O(F) sea cual sea el nmero
+ * de semigrupos. Cada semigrupo se imprime en cuanto se visita, seguido de su
+ * clasificacin, y no se guarda ninguno.
+ */
+RecuentoFrobenius generaSemigruposConFProfundidad(int F, bool imprime) {
+   RecuentoFrobenius recuento;
+   vector<MarcoPila> pila;
+
+   auto visita = [&](Candidato&& nodo) {
+      bool hoja = esHojaFrobenius(nodo.semigrupo, F);
+      if (hoja)
+         recuento.hojas++;
+      else
+         recuento.internos++;
+      if (imprime)
+         cout << lineaSemigrupo(nodo.semigrupo, nodo.apery, F) << " | " << (hoja ? "hoja" : "interno") << "\n";
+
+      MarcoPila marco;
+      marco.huecos = huecosEspeciales(nodo.semigrupo, nodo.apery, nodo.semigrupo[0]);
+      marco.siguiente = 0;
+      marco.nodo = std::move(nodo);
+      pila.push_back(std::move(marco));
+   };
+
+   ConjuntoGeneradores S0 = minimizarGeneradores(semigrupoInicial(F));
+   visita(Candidato{0, S0, aperyPorResiduo(S0, F+1)});
+
+   while (!pila.empty()) {
+      MarcoPila& cima = pila.back();
+      if (cima.siguiente == cima.huecos.size()) {
+         pila.pop_back();
+         continue;
+      }
+      int x = cima.huecos[cima.siguiente++];
+      if (x == F)
+         continue;
+      //visita apila un marco nuevo, as que cima deja de ser vlida tras la llamada
+      visita(hijoConHueco(cima.nodo.semigrupo, cima.nodo.apery, x, nullptr));
+   }
+
+   return recuento;
+}
+
+/**
+ * @brief Recorrido empleado para enumerar los semigrupos con Frobenius fijo.
+ */
+enum class Recorrido {
+   AMPLITUD,    //Bsqueda en amplitud con conjunto de vistos.
+   CANONICO,    //rbol de padres cannicos, sin conjunto de vistos.
+   PROFUNDIDAD  //rbol de padres cannicos en profundidad, con salida en flujo.
+};
+
 /**
  * @brief Punto de entrada: valida F, lanza la generacin y clasifica resultados.
+ * @param[in] argc Nmero de argumentos.
+ * @param[in] argv Argumentos; admite --simd=auto (por defecto), escalar, avx2 o avx512,
+ *                 --hilos=N con N entre 1 y 999 (por defecto, los hilos hardware disponibles),
+ *                 --recorrido=amplitud (por defecto), canonico o profundidad, --solo-contar,
+ *                 --arena=si (por defecto) o no y --estadisticas-arena.
  * @return Cdigo de salida (0 xito, 1 error de entrada).
  */
-int main(){
+int main(int argc, char* argv[]){
+   string simd = "auto";
+   int hilos = max((int)thread::hardware_concurrency(), 1);
+   Recorrido recorrido = Recorrido::AMPLITUD;
+   bool soloContar = false;
+   bool estadisticasArena = false;
+   for (int i = 1; i < argc; i++) {
+      string opcion = argv[i];
+      if (opcion.compare(0, 7, "--simd=") == 0)
+         simd = opcion.substr(7);
+      else if (regex_match(opcion, regex("^--hilos=[1-9][0-9]{0,2}$")))
+         hilos = stoi(opcion.substr(8));
+      else if (opcion == "--recorrido=amplitud")
+         recorrido = Recorrido::AMPLITUD;
+      else if (opcion == "--recorrido=canonico")
+         recorrido = Recorrido::CANONICO;
+      else if (opcion == "--recorrido=profundidad")
+         recorrido = Recorrido::PROFUNDIDAD;
+      else if (opcion == "--solo-contar")
+         soloContar = true;
+      else if (opcion == "--arena=si")
+         arenasActivas = true;
+      else if (opcion == "--arena=no")
+         arenasActivas = false;
+      else if (opcion == "--estadisticas-arena")
+         estadisticasArena = true;
+      else {
+         cout << "Opcion no valida: " << opcion << ". Usa --simd=auto|escalar|avx2|avx512, --hilos=N,"
+              << " --recorrido=amplitud|canonico|profundidad, --solo-contar, --arena=si|no"
+              << " y --estadisticas-arena." << endl;
+         return 1;
+      }
+   }
+   if (!seleccionaKernel(simd)) {
+      cout << "El juego de instrucciones '" << simd << "' no es valido o no esta disponible en esta CPU." << endl;
+      return 1;
+   }
+
    string input;
    cout << "Numero de Frobenius (F): ";
    getline(cin, input);
@@ -298,39 +1337,47 @@ int main(){
    //Se generan todos los semigrupos numricos con Frobenius = F
    auto inicio = chrono::high_resolution_clock::now();
     
-   auto todos = generaSemigruposConF(F);
-    
-   //Se pasa a clasificar si los semigrupos numricos son internos u hojas
-   vector<vector<int>> internos, hojas;
-   for (auto &S : todos) {
-      bool todoMenor = true;
-      for (int g : S) {
-         if (g >= F) {
-            todoMenor = false;
-            break;
-         }
-      }
-      if (todoMenor)
-         hojas.push_back(S);
+   ListaSemigrupos todos;
+   RecuentoFrobenius recuento;
+   if (soloContar) {
+      //Solo los totales: el recorrido en profundidad sin imprimir ni guardar nada
+      recuento = generaSemigruposConFProfundidad(F, false);
+   } else if (recorrido == Recorrido::PROFUNDIDAD) {
+      //La clasificacin se hace al vuelo y no se guarda ningn semigrupo
+      recuento = generaSemigruposConFProfundidad(F, true);
+   } else {
+      //Cada semigrupo se clasifica en interno u hoja al guardarlo en la lista
+      if (recorrido == Recorrido::CANONICO)
+         todos = generaSemigruposConFCanonico(F, hilos);
       else
-         internos.push_back(S);
+         todos = (hilos > 1) ? generaSemigruposConFParalelo(F, hilos) : generaSemigruposConF(F);
+      recuento.hojas = cuentaHojas(todos);
+      recuento.internos = numSemigrupos(todos) - recuento.hojas;
    }
     
    auto fin = chrono::high_resolution_clock::now();
    auto duracion = chrono::duration_cast<chrono::seconds>(fin - inicio).count();
 
-   cout << "\nSemigrupos numericos internos\n";
-   for (auto &S : internos) {
-      cout << semigrupoAString(S) << "\n";
-   }
+   if (!soloContar && recorrido != Recorrido::PROFUNDIDAD) {
+      cout << "\nSemigrupos numericos internos\n";
+      imprimeLista(todos, false);
 
-   cout << "\nSemigrupos numericos hoja\n";
-   for (auto &S : hojas) {
-      cout << semigrupoAString(S) << "\n";
+      cout << "\nSemigrupos numericos hoja\n";
+      imprimeLista(todos, true);
    }
 
-   cout << "\nTotal internos: " << internos.size()
-      << "   Total hojas: " << hojas.size() << "\n";
+   cout << "\nTotal internos: " << recuento.internos
+      << "   Total hojas: " << recuento.hojas << "\n";
+
+   if (estadisticasArena && (soloContar || recorrido == Recorrido::PROFUNDIDAD)) {
+      //El recorrido en profundidad no guarda conjuntos de Apry y no pasa por las arenas
+      cout << "Memoria temporal: el recorrido en profundidad no usa arenas.\n";
+   } else if (estadisticasArena) {
+      uint64_t visitados = recuento.internos + recuento.hojas;
+      cout << "Memoria temporal (" << (arenasActivas ? "arenas" : "new/delete") << "): "
+           << bytesArenas << " bytes, " << (visitados ? bytesArenas / visitados : 0)
+           << " bytes por semigrupo\n";
+   }
       
    cout << "\nEl programa ha tardado " << duracion << " segundos.\n";
 
@@ -12,85 +12,311 @@
 
 #include <string>
 #include <vector>
+#include <array>
 #include <set>
+#include <cstdint>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <utility>
+#include <type_traits>
 
 namespace semigrupo {
 
 /**
- * @brief Convierte un vector de generadores en su notacin de semigrupo <g1,,gk>.
+ * @brief Nmero de generadores que un ConjuntoGeneradores guarda sin memoria dinmica.
+ */
+const int GENERADORES_EN_LINEA = 32;
+
+/**
+ * @brief Conjunto ordenado de generadores positivos y distintos, con hasta
+ *        GENERADORES_EN_LINEA guardados en lnea (16 bits) y el resto en memoria dinmica.
+ *        Se construye implcitamente desde un std::vector<int> en cualquier orden.
+ */
+struct ConjuntoGeneradores {
+    uint16_t enLinea[GENERADORES_EN_LINEA] = {};  //Generadores, si caben.
+    std::vector<uint16_t> desbordados;            //Todos los generadores, si no caben.
+    int tamano = 0;                               //Nmero de generadores.
+
+    ConjuntoGeneradores() {}
+    ConjuntoGeneradores(const std::vector<int>& S);
+
+    const uint16_t* begin() const;
+    const uint16_t* end() const;
+    size_t size() const;
+    bool empty() const;
+    int operator[](size_t i) const;
+    int front() const;
+    int back() const;
+};
+
+/**
+ * @brief Aade un generador mayor que todos los del conjunto.
+ * @param G Conjunto.
+ * @param x Nuevo generador.
+ */
+void anadeGenerador(ConjuntoGeneradores& G, int x);
+
+/**
+ * @brief Inserta un generador en su posicin, si no estaba ya.
+ * @param G Conjunto.
+ * @param x Generador positivo.
+ */
+void insertaGenerador(ConjuntoGeneradores& G, int x);
+
+/**
+ * @brief Convierte un conjunto de generadores en su notacin de semigrupo <g1,,gk>.
  * @param generadores Conjunto de generadores del semigrupo.
  * @return Cadena con el semigrupo en notacin angular.
  */
-std::string semigrupoAString(const std::vector<int>& generadores);
+std::string semigrupoAString(const ConjuntoGeneradores& generadores);
 
 /**
  * @brief Alias de semigrupoAString para contextos de Apry.
  * @param generadores Conjunto de generadores.
  * @return Misma salida que semigrupoAString.
  */
-std::string corchetesAngulares(const std::vector<int>& generadores);
+std::string corchetesAngulares(const ConjuntoGeneradores& generadores);
+
+/**
+ * @brief Conjunto de enteros de [0, 64PALABRAS) guardado como bits de ancho fijo,
+ *        sin reservas de memoria.
+ */
+template <int PALABRAS>
+struct BitsFijos {
+    std::array<uint64_t, PALABRAS> bloques;
+};
+
+/**
+ * @brief Comprueba si i (0 <= i < 64PALABRAS) est en el conjunto.
+ * @param R Conjunto.
+ * @param i Entero de la ventana.
+ * @return true si su bit est a 1.
+ */
+template <int PALABRAS>
+bool contieneFijo(const BitsFijos<PALABRAS>& R, int i);
+
+/**
+ * @brief Hace R |= R << k dentro de la ventana.
+ * @param R Conjunto.
+ * @param k Desplazamiento (0 < k < 64PALABRAS).
+ */
+template <int PALABRAS>
+void cierraDesplazamientoFijo(BitsFijos<PALABRAS>& R, int k);
+
+/**
+ * @brief Versin de esRepresentable sobre una ventana fija de 64PALABRAS bits.
+ * @param valor Entero a verificar (0 <= valor < 64PALABRAS).
+ * @param generadores Conjunto de generadores del semigrupo.
+ * @return true si `valor` pertenece al semigrupo generado.
+ */
+template <int PALABRAS>
+bool esRepresentableFijo(int valor, const ConjuntoGeneradores& generadores);
 
 /**
  * @brief Comprueba si un valor es representable como combinacin no negativa de generadores.
  * @param valor Entero a verificar.
  * @param generadores Conjunto de generadores del semigrupo.
  * @return true si existe combinacin de enteros >= 0 que sume `valor`.
+ * @details Con valor < 1024 usa la menor instanciacin de esRepresentableFijo.
+ */
+bool esRepresentable(int valor, const ConjuntoGeneradores& generadores);
+
+/**
+ * @brief Suma con saturacin 1 en destino donde origen es no nulo (versin escalar).
+ * @param destino Array de contadores.
+ * @param origen Array que indica pertenencia.
+ * @param n Nmero de posiciones a actualizar.
+ */
+void sumaPertenenciaEscalar(uint8_t* destino, const uint8_t* origen, int n);
+
+/**
+ * @brief Kernel que suma pertenencias a los nmeros de descomposiciones.
  */
-bool esRepresentable(int valor, const std::vector<int>& generadores);
+struct KernelDescomposiciones {
+    void (*suma)(uint8_t*, const uint8_t*, int);  //destino[i] += (origen[i] != 0), con saturacin.
+    const char* nombre;                           //Juego de instrucciones empleado.
+};
+
+extern KernelDescomposiciones kernelDescomposiciones;
+
+/**
+ * @brief Selecciona el kernel de descomposiciones segn la preferencia y la CPU.
+ * @param preferencia "auto", "escalar", "avx2" o "avx512".
+ * @return true si la preferencia es vlida y la CPU la admite.
+ */
+bool seleccionaKernel(const std::string& preferencia);
 
 /**
  * @brief Reduce un conjunto de generadores eliminando los redundantes.
- * @param generadores Vector inicial de generadores.
- * @return Nuevo vector sin generadores representables por los dems.
+ * @param generadores Conjunto inicial de generadores.
+ * @return Nuevo conjunto sin generadores representables por los dems.
  */
-std::vector<int> minimizarGeneradores(std::vector<int> generadores);
+ConjuntoGeneradores minimizarGeneradores(const ConjuntoGeneradores& generadores);
 
 /**
- * @brief Verifica la validez del Frobenius de un semigrupo.
- * @param generadores Conjunto de generadores minimizados.
- * @param F Valor de Frobenius a comprobar.
- * @return true si F no es representable y F+1 s lo es.
+ * @brief Tamao mnimo de cada bloque que una Arena pide al sistema.
  */
-bool frobeniusValido(const std::vector<int>& generadores, int F);
+const size_t BLOQUE_ARENA = 1 << 20;
+
+/**
+ * @brief Si las arenas sirven la memoria (true) o solo la cuentan y delegan en new/delete (false).
+ */
+extern bool arenasActivas;
+
+/**
+ * @brief Bytes pedidos a todas las arenas ya destruidas.
+ */
+extern std::atomic<uint64_t> bytesArenas;
+
+/**
+ * @brief Arena montona por hilo: reparte memoria de bloques grandes que solo se liberan
+ *        todos a la vez, al reiniciarla entre niveles de la bsqueda.
+ */
+struct Arena {
+    std::vector<std::pair<char*, size_t>> bloques;  //Bloques reservados y su tamao.
+    size_t bloque = 0;                              //Bloque en uso.
+    size_t usado = 0;                               //Bytes ocupados del bloque en uso.
+    uint64_t pedidos = 0;                           //Bytes servidos, tambin con las arenas desactivadas.
+
+    Arena() {}
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    ~Arena();
+};
+
+/**
+ * @brief Reserva memoria de una arena (alineada a 16 bytes).
+ * @param arena Arena.
+ * @param bytes Nmero de bytes.
+ * @return Puntero vlido hasta el siguiente reiniciaArena.
+ */
+void* reservaArena(Arena& arena, size_t bytes);
+
+/**
+ * @brief Da por libre toda la memoria de una arena, conservando sus bloques.
+ * @param arena Arena; nada de lo reservado antes puede seguir en uso.
+ */
+void reiniciaArena(Arena& arena);
+
+/**
+ * @brief Asignador para contenedores estndar que toma la memoria de una Arena
+ *        (sin arena, new/delete). Se propaga al mover e intercambiar contenedores.
+ */
+template <class T>
+struct AsignadorArena {
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    Arena* arena;
+
+    AsignadorArena();
+    explicit AsignadorArena(Arena* a);
+    template <class U>
+    AsignadorArena(const AsignadorArena<U>& otro);
+
+    T* allocate(size_t n);
+    void deallocate(T* p, size_t n);
+};
+
+/**
+ * @brief Conjunto de Apry indexado por resto, con la memoria de una arena si se indica.
+ */
+typedef std::vector<int, AsignadorArena<int>> VectorApery;
+
+/**
+ * @brief Aade un generador a un conjunto de Apry con una vuelta del algoritmo
+ *        round-robin, en O(n).
+ * @param w Conjunto de Apry indexado por resto mdulo n = w.size() (-1 = inalcanzable).
+ * @param a Nuevo generador.
+ */
+void anadeGeneradorApery(VectorApery& w, int a);
+
+/**
+ * @brief Calcula el conjunto de Apry indexado por resto con el algoritmo round-robin
+ *        (BckerLiptk), en O(kn) tiempo y O(n) memoria.
+ * @param generadores Conjunto de generadores.
+ * @param modulo Entero n > 0 respecto al que se calcula.
+ * @return Vector w de tamao n con el menor elemento de cada resto, o -1 si no existe.
+ */
+VectorApery aperyPorResiduo(const ConjuntoGeneradores& generadores, int modulo);
 
 /**
  * @brief Construye el semigrupo inicial S0 = <F+1, F+2, , 2F+1>.
  * @param F Valor de Frobenius.
- * @return Vector de generadores de S0.
+ * @return Generadores de S0.
  */
-std::vector<int> semigrupoInicial(int F);
+ConjuntoGeneradores semigrupoInicial(int F);
 
 /**
  * @brief Candidato para aadir nuevo generador.
  */
 struct Candidato {
-    int x;                         //Elemento candidato a aadir.
-    std::vector<int> semigrupo;   //Semigrupo resultante tras la minimizacin.
+    int x;                           //Elemento candidato a aadir (0 en la raz y en los nodos guardados por nivel).
+    ConjuntoGeneradores semigrupo;   //Semigrupo resultante tras la minimizacin.
+    VectorApery apery;               //Ap(semigrupo, F+1) indexado por resto.
 };
 
 /**
- * @brief Obtiene los candidatos que pueden aadirse manteniendo Frobenius = F.
+ * @brief Comprueba si un entero pertenece al semigrupo a partir de su conjunto de Apry.
+ * @param w Conjunto de Apry indexado por resto (-1 = inalcanzable).
+ * @param y Entero a comprobar.
+ * @return true si y es mayor o igual que el menor elemento de su clase de resto.
+ */
+bool perteneceApery(const VectorApery& w, int y);
+
+/**
+ * @brief Calcula los huecos especiales (pseudo-Frobenius x con 2x en S) de un semigrupo
+ *        con Frobenius F, es decir, los x para los que S unin {x} es un semigrupo.
+ * @param S Generadores minimales del semigrupo.
+ * @param apery Ap(S, F+1) indexado por resto.
+ * @param hasta Solo se buscan huecos menores que este valor.
+ * @return Huecos especiales menores que hasta en orden creciente.
+ */
+std::vector<int> huecosEspeciales(const ConjuntoGeneradores& S, const VectorApery& apery, int hasta);
+
+/**
+ * @brief Construye el hijo S unin {x} (x hueco especial distinto de F) en O(e).
+ * @param S Generadores minimales del padre.
+ * @param apery Ap(S, F+1) indexado por resto.
+ * @param x Hueco especial de S.
+ * @param arena Arena para el Apry del hijo (nullptr: memoria dinmica).
+ * @return Candidato con x, los generadores minimales del hijo y su Apry.
+ */
+Candidato hijoConHueco(const ConjuntoGeneradores& S, const VectorApery& apery, int x, Arena* arena);
+
+/**
+ * @brief Obtiene los hijos S unin {x}, con x hueco especial distinto de F, que conservan
+ *        Frobenius = F; el Apry y los generadores minimales de cada hijo se derivan
+ *        del padre en O(e).
  * @param S Conjunto actual de generadores minimizados.
+ * @param apery Ap(S, F+1) indexado por resto.
  * @param F Valor de Frobenius objetivo.
- * @return Vector de Candidato con cada posible x y su semigrupo.
+ * @param arena Arena para el Apry de los candidatos (nullptr: memoria dinmica).
+ * @return Vector de Candidato con cada posible x, su semigrupo y su Apry.
  */
-std::vector<Candidato> obtenerCandidatos(const std::vector<int>& S, int F);
+std::vector<Candidato> obtenerCandidatos(const ConjuntoGeneradores& S, const VectorApery& apery, int F, Arena* arena);
 
 /**
- * @brief Calcula el conjunto de Apry de un semigrupo respecto a un periodo.
- * @param generadores Conjunto de generadores minimizados.
- * @param periodo Entero de referencia (normalmente F+1).
- * @return Vector size=periodo con los menores valores representables de cada resto.
+ * @brief Obtiene solo los hijos de los que S es el padre cannico (T sin su multiplicidad),
+ *        es decir, S unin {x} con x hueco especial menor que la multiplicidad de S.
+ * @param S Conjunto actual de generadores minimizados.
+ * @param apery Ap(S, F+1) indexado por resto.
+ * @param F Valor de Frobenius objetivo.
+ * @param arena Arena para el Apry de los hijos (nullptr: memoria dinmica).
+ * @return Hijos cannicos de S.
  */
-std::vector<int> conjuntoApery(const std::vector<int>& generadores, int periodo);
+std::vector<Candidato> obtenerHijosCanonicos(const ConjuntoGeneradores& S, const VectorApery& apery, int F, Arena* arena);
 
 /**
- * @brief Convierte el conjunto de Apry a cadena.
+ * @brief Convierte a cadena un conjunto de Apry ya calculado.
  * @param generadores Conjunto de generadores.
+ * @param apery Conjunto de Apry indexado por resto mdulo periodo.
  * @param periodo Periodo usado en el clculo (F+1).
  * @return Cadena con formato Ap(<generadores>, periodo) = {a0,,a_{periodo-1}}.
  */
-std::string aperyAString(const std::vector<int>& generadores, int periodo);
+std::string aperyAString(const ConjuntoGeneradores& generadores, const VectorApery& apery, int periodo);
 
 /**
  * @brief Comprueba si un semigrupo ya ha sido procesado para evitar duplicados.
@@ -98,14 +324,228 @@ std::string aperyAString(const std::vector<int>& generadores, int periodo);
  * @param vistos Conjunto de representaciones en cadena ya mostradas.
  * @return true si semigrupoAString(S) est en vistos.
  */
-bool yaVisto(const std::vector<int>& S, const std::set<std::string>& vistos);
+bool yaVisto(const ConjuntoGeneradores& S, const std::set<std::string>& vistos);
+
+/**
+ * @brief Lista compacta de semigrupos en formato CSR (filas comprimidas).
+ * @details
+ *   Los generadores de todos los semigrupos van seguidos en un nico array de 16 bits y
+ *   el semigrupo i ocupa valores[inicios[i]..inicios[i+1]). La clasificacin en hoja o
+ *   interno se guarda en un mapa de bits aparte.
+ */
+struct ListaSemigrupos {
+    std::vector<uint16_t> valores;                               //Generadores de todos los semigrupos, seguidos.
+    std::vector<uint32_t> inicios = std::vector<uint32_t>(1, 0); //Inicio de cada semigrupo y final del ltimo.
+    std::vector<uint64_t> hojas;                                 //Bit i a 1 si el semigrupo i es hoja.
+};
+
+/**
+ * @brief Nmero de semigrupos de una lista.
+ * @param L Lista.
+ * @return Nmero de semigrupos guardados.
+ */
+size_t numSemigrupos(const ListaSemigrupos& L);
+
+/**
+ * @brief Aade un semigrupo al final de una lista.
+ * @param L Lista.
+ * @param generadores Generadores minimales, en el orden en que se guardarn.
+ * @param tamano Nmero de generadores.
+ * @param hoja Si el semigrupo es hoja.
+ */
+void anadeSemigrupo(ListaSemigrupos& L, const uint16_t* generadores, size_t tamano, bool hoja);
+
+/**
+ * @brief Aade un semigrupo al final de una lista.
+ * @param L Lista.
+ * @param S Generadores minimales.
+ * @param hoja Si el semigrupo es hoja.
+ */
+void anadeSemigrupo(ListaSemigrupos& L, const ConjuntoGeneradores& S, bool hoja);
+
+/**
+ * @brief Indica si el semigrupo i de la lista es hoja.
+ * @param L Lista.
+ * @param i ndice del semigrupo.
+ * @return true si es hoja.
+ */
+bool esHojaLista(const ListaSemigrupos& L, size_t i);
+
+/**
+ * @brief Nmero de generadores del semigrupo i de la lista.
+ * @param L Lista.
+ * @param i ndice del semigrupo.
+ * @return Tamao de su sistema minimal.
+ */
+size_t tamanoSemigrupo(const ListaSemigrupos& L, size_t i);
+
+/**
+ * @brief Generadores del semigrupo i de la lista, sin copiarlos.
+ * @param L Lista.
+ * @param i ndice del semigrupo.
+ * @return Puntero a sus tamanoSemigrupo(L, i) generadores.
+ */
+const uint16_t* generadoresSemigrupo(const ListaSemigrupos& L, size_t i);
+
+/**
+ * @brief Cuenta las hojas de una lista.
+ * @param L Lista.
+ * @return Nmero de semigrupos marcados como hoja.
+ */
+uint64_t cuentaHojas(const ListaSemigrupos& L);
+
+/**
+ * @brief Imprime, uno por lnea como <a,b,...>, los semigrupos de la lista de una clase.
+ * @param L Lista.
+ * @param hojas true para imprimir las hojas y false para los internos.
+ */
+void imprimeLista(const ListaSemigrupos& L, bool hojas);
+
+/**
+ * @brief Indica si un semigrupo con Frobenius F es hoja (todos sus generadores son menores que F).
+ * @param S Generadores minimales.
+ * @param F Valor de Frobenius.
+ * @return true si es hoja, false si es interno.
+ */
+bool esHojaFrobenius(const ConjuntoGeneradores& S, int F);
 
 /**
  * @brief Genera e imprime todos los semigrupos con Frobenius = F en BFS.
  * @param F Valor de Frobenius deseado.
- * @return Vector de todos los semigrupos minimizados encontrados.
+ * @return Lista de todos los semigrupos minimizados encontrados, clasificados en internos y hojas.
+ */
+ListaSemigrupos generaSemigruposConF(int F);
+
+/**
+ * @brief Clave compacta de un semigrupo: bits de sus generadores minimales.
+ */
+struct ClaveSemigrupo {
+    std::vector<uint64_t> bits;
+    bool operator==(const ClaveSemigrupo& otra) const { return bits == otra.bits; }
+};
+
+/**
+ * @brief Funcin hash para ClaveSemigrupo.
+ */
+struct HashClave {
+    size_t operator()(const ClaveSemigrupo& clave) const;
+};
+
+/**
+ * @brief Construye la clave compacta de un sistema minimal de generadores.
+ * @param generadores Generadores minimales.
+ * @return Clave con un bit por generador.
+ */
+ClaveSemigrupo claveCompacta(const ConjuntoGeneradores& generadores);
+
+/**
+ * @brief Conjunto hash concurrente, dividido en fragmentos con su propio cerrojo.
+ */
+struct ConjuntoConcurrente {
+    static const int FRAGMENTOS = 64;
+    struct Fragmento {
+        std::mutex cerrojo;
+        std::unordered_map<ClaveSemigrupo, uint64_t, HashClave> ordenes;
+    };
+    Fragmento fragmentos[FRAGMENTOS];
+};
+
+/**
+ * @brief Registra una clave con su orden, conservando el menor si ya exista.
+ * @param conjunto Conjunto concurrente.
+ * @param clave Clave del semigrupo.
+ * @param orden Orden de descubrimiento.
+ */
+void registraMinimo(ConjuntoConcurrente& conjunto, const ClaveSemigrupo& clave, uint64_t orden);
+
+/**
+ * @brief Devuelve el menor orden registrado para una clave.
+ * @param conjunto Conjunto concurrente.
+ * @param clave Clave ya registrada.
+ * @return Orden de descubrimiento ganador.
+ */
+uint64_t ordenRegistrado(ConjuntoConcurrente& conjunto, const ClaveSemigrupo& clave);
+
+/**
+ * @brief Candidato encontrado por un hilo durante un nivel de la bsqueda paralela.
+ */
+struct EntradaNivel {
+    uint64_t orden;                  //(nivel, ndice del padre, ndice del candidato) empaquetados.
+    ClaveSemigrupo clave;            //Clave compacta del semigrupo.
+    ConjuntoGeneradores semigrupo;   //Generadores minimales.
+    VectorApery apery;               //Ap(semigrupo, F+1) indexado por resto.
+    std::string linea;               //Lnea a imprimir (solo para los ganadores).
+};
+
+/**
+ * @brief Empaqueta el orden de descubrimiento de la bsqueda en amplitud secuencial.
+ * @param nivel Nivel de la bsqueda.
+ * @param padre ndice del padre dentro de su nivel.
+ * @param candidato ndice del candidato dentro de los de su padre.
+ * @return Entero cuyo orden coincide con el de la bsqueda secuencial.
+ */
+uint64_t codificaOrden(uint64_t nivel, uint64_t padre, uint64_t candidato);
+
+/**
+ * @brief Formatea un semigrupo y su conjunto de Apry en columnas alineadas.
+ * @param S Generadores minimales.
+ * @param apery Ap(S, F+1) indexado por resto.
+ * @param F Valor de Frobenius.
+ * @return Lnea de salida sin salto de lnea.
+ */
+std::string lineaSemigrupo(const ConjuntoGeneradores& S, const VectorApery& apery, int F);
+
+/**
+ * @brief Genera e imprime todos los semigrupos con Frobenius = F en BFS repartiendo cada nivel entre hilos.
+ * @param F Valor de Frobenius deseado.
+ * @param hilos Nmero de hilos.
+ * @return Lista de todos los semigrupos minimizados, en el mismo orden que la versin secuencial.
+ */
+ListaSemigrupos generaSemigruposConFParalelo(int F, int hilos);
+
+/**
+ * @brief Genera e imprime todos los semigrupos con Frobenius = F recorriendo el rbol de
+ *        padres cannicos, sin conjunto de vistos.
+ * @param F Valor de Frobenius deseado.
+ * @param hilos Nmero de hilos.
+ * @return Lista de todos los semigrupos minimizados, en orden de recorrido.
  */
-std::vector<std::vector<int>> generaSemigruposConF(int F);
+ListaSemigrupos generaSemigruposConFCanonico(int F, int hilos);
+
+/**
+ * @brief Marco de la pila del recorrido en profundidad: un semigrupo y sus hijos pendientes.
+ */
+struct MarcoPila {
+    Candidato nodo;               //Semigrupo con su Ap(S, F+1).
+    std::vector<int> huecos;      //Huecos especiales menores que la multiplicidad.
+    size_t siguiente;             //ndice del siguiente hueco a expandir.
+};
+
+/**
+ * @brief Recuento de semigrupos internos y hojas.
+ */
+struct RecuentoFrobenius {
+    uint64_t internos = 0;
+    uint64_t hojas = 0;
+};
+
+/**
+ * @brief Genera e imprime en profundidad (pila explcita sobre el rbol de padres cannicos)
+ *        todos los semigrupos con Frobenius = F, clasificndolos al vuelo sin guardarlos.
+ * @param F Valor de Frobenius deseado.
+ * @param imprime Si se imprime cada semigrupo (false: solo se cuentan).
+ * @return Nmero de semigrupos internos y hojas.
+ */
+RecuentoFrobenius generaSemigruposConFProfundidad(int F, bool imprime);
+
+/**
+ * @brief Recorrido empleado para enumerar los semigrupos con Frobenius fijo.
+ */
+enum class Recorrido {
+    AMPLITUD,    //Bsqueda en amplitud con conjunto de vistos.
+    CANONICO,    //rbol de padres cannicos, sin conjunto de vistos.
+    PROFUNDIDAD  //rbol de padres cannicos en profundidad, con salida en flujo.
+};
 
 }
 
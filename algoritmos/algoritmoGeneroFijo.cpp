@@ -9,6 +9,7 @@
 
 #include <iostream>
 #include <vector>
+#include <array>
 #include <algorithm>
 #include <numeric>
 #include <unordered_map>
@@ -17,375 +18,2104 @@
 #include <utility>
 #include <chrono>
 #include <regex>
+#include <cstdint>
+#include <climits>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SEMIGRUPO_SIMD_X86 1
+#endif
 
 using namespace std;
 
-unordered_map<string, int> cacheGenero;
-unordered_map<string, int> cacheFrobenius;
+/**
+ * @brief Calcula el mximo comn divisor entre dos enteros.
+ * @param[in] a Primer operando.
+ * @param[in] b Segundo operando.
+ * @return El mximo comn divisor de a y b.
+ */
+int maxCD(int a, int b) {
+   while (b) {
+      a %= b;
+      swap(a, b);
+   }
+   return a;
+}
+
+/**
+ * @brief Nmero de generadores que un ConjuntoGeneradores guarda sin memoria dinmica.
+ */
+const int GENERADORES_EN_LINEA = 32;
+
+/**
+ * @brief Conjunto ordenado de generadores con capacidad en lnea.
+ * @details
+ *   Hasta GENERADORES_EN_LINEA generadores se guardan en un array de 16 bits dentro del
+ *   propio valor, as que crearlo o copiarlo en los bucles internos no reserva memoria;
+ *   si hay ms, todos pasan a `desbordados`. Los valores son positivos, menores que
+ *   65536, distintos y crecientes. Se construye implcitamente desde un vector<int>
+ *   (en cualquier orden; los repetidos y los no positivos se descartan), de modo que
+ *   las funciones que lo reciben siguen aceptando vectores.
+ */
+struct ConjuntoGeneradores {
+   uint16_t enLinea[GENERADORES_EN_LINEA] = {};  //Generadores, si caben.
+   vector<uint16_t> desbordados;                 //Todos los generadores, si no caben.
+   int tamano = 0;                               //Nmero de generadores.
+
+   ConjuntoGeneradores() {}
+   ConjuntoGeneradores(const vector<int>& S);
+
+   const uint16_t* begin() const { return tamano <= GENERADORES_EN_LINEA ? enLinea : desbordados.data(); }
+   const uint16_t* end() const { return begin() + tamano; }
+   size_t size() const { return tamano; }
+   bool empty() const { return tamano == 0; }
+   int operator[](size_t i) const { return begin()[i]; }
+   int front() const { return begin()[0]; }
+   int back() const { return begin()[tamano - 1]; }
+};
+
+/**
+ * @brief Aade un generador mayor que todos los del conjunto.
+ * @param[in,out] G Conjunto.
+ * @param[in] x Nuevo generador.
+ */
+void anadeGenerador(ConjuntoGeneradores& G, int x) {
+   if (G.tamano < GENERADORES_EN_LINEA) {
+      G.enLinea[G.tamano] = (uint16_t)x;
+   } else {
+      if (G.tamano == GENERADORES_EN_LINEA)
+         G.desbordados.assign(G.enLinea, G.enLinea + GENERADORES_EN_LINEA);
+      G.desbordados.push_back((uint16_t)x);
+   }
+   ++G.tamano;
+}
+
+/**
+ * @brief Inserta un generador en su posicin, si no estaba ya.
+ * @param[in,out] G Conjunto.
+ * @param[in] x Generador positivo.
+ */
+void insertaGenerador(ConjuntoGeneradores& G, int x) {
+   size_t posicion = lower_bound(G.begin(), G.end(), x) - G.begin();
+   if (posicion < G.size() && G[posicion] == x)
+      return;
+   anadeGenerador(G, x);
+   uint16_t* datos = G.tamano <= GENERADORES_EN_LINEA ? G.enLinea : G.desbordados.data();
+   rotate(datos + posicion, datos + G.tamano - 1, datos + G.tamano);
+}
+
+ConjuntoGeneradores::ConjuntoGeneradores(const vector<int>& S) {
+   for (int s : S)
+      if (s > 0)
+         insertaGenerador(*this, s);
+}
+
+/**
+ * @brief Nmero de enteros cuya pertenencia guarda un SemigrupoBits.
+ */
+const int BITS_SEMIGRUPO = 256;
+const int PALABRAS_SEMIGRUPO = BITS_SEMIGRUPO / 64;
+
+/**
+ * @brief Mayor gnero alcanzable por el recorrido del rbol con SemigrupoBits.
+ * @details
+ *   Los nodos de gnero g tienen generadores minimales hasta F + m <= 3g, y sus hijos
+ *   necesitan un bit ms, por lo que se exige 3g + 2 <= BITS_SEMIGRUPO.
+ */
+const int GENERO_MAXIMO_ARBOL = (BITS_SEMIGRUPO - 2) / 3;
+
+/**
+ * @brief Semigrupo numrico representado por un array de bits de ancho fijo.
+ * @details
+ *   El bit i de `bloques` est a 1 si i pertenece al semigrupo. Todo entero mayor o
+ *   igual que BITS_SEMIGRUPO se considera dentro del semigrupo, lo que es correcto
+ *   siempre que el conductor sea menor que BITS_SEMIGRUPO. Se guardan tambin la
+ *   multiplicidad, el Frobenius y el gnero para no recalcularlos.
+ */
+struct SemigrupoBits {
+   uint64_t bloques[PALABRAS_SEMIGRUPO];  //Pertenencia de 0..BITS_SEMIGRUPO-1.
+   int multiplicidad;                     //Menor elemento no nulo.
+   int frobenius;                         //Mayor entero que no pertenece (-1 para N).
+   int genero;                            //Nmero de huecos.
+};
+
+/**
+ * @brief Comprueba si un entero pertenece al semigrupo.
+ * @param[in] S Semigrupo.
+ * @param[in] i Entero no negativo.
+ * @return true si i est en S.
+ */
+bool pertenece(const SemigrupoBits& S, int i) {
+   if (i >= BITS_SEMIGRUPO)
+      return true;
+   return (S.bloques[i >> 6] >> (i & 63)) & 1;
+}
+
+/**
+ * @brief Desplaza un array de bits k posiciones hacia los ndices mayores.
+ * @param[in] origen Array de PALABRAS_SEMIGRUPO palabras.
+ * @param[in] k Desplazamiento (k >= 0).
+ * @param[out] destino Resultado; el bit i de origen pasa al bit i+k (se pierden los que salen).
+ */
+void desplazaBits(const uint64_t* origen, int k, uint64_t* destino) {
+   int palabras = k >> 6;
+   int bits = k & 63;
+   for (int i = PALABRAS_SEMIGRUPO - 1; i >= 0; --i) {
+      int j = i - palabras;
+      uint64_t valor = 0;
+      if (j >= 0) {
+         valor = origen[j] << bits;
+         if (bits != 0 && j > 0)
+            valor |= origen[j - 1] >> (64 - bits);
+      }
+      destino[i] = valor;
+   }
+}
+
+/**
+ * @brief Recalcula multiplicidad, Frobenius y gnero a partir de los bits.
+ * @param[in,out] S Semigrupo cuyos bloques ya estn rellenos.
+ */
+void actualizaInvariantes(SemigrupoBits& S) {
+   S.multiplicidad = BITS_SEMIGRUPO;
+   S.frobenius = -1;
+   S.genero = 0;
+   for (int i = 0; i < PALABRAS_SEMIGRUPO; ++i) {
+      uint64_t palabra = (i == 0) ? (S.bloques[0] & ~1ULL) : S.bloques[i];
+      uint64_t huecos = ~S.bloques[i];
+      if (palabra != 0 && S.multiplicidad == BITS_SEMIGRUPO)
+         S.multiplicidad = 64 * i + __builtin_ctzll(palabra);
+      if (huecos != 0) {
+         S.frobenius = 64 * i + 63 - __builtin_clzll(huecos);
+         S.genero += __builtin_popcountll(huecos);
+      }
+   }
+}
+
+/**
+ * @brief Construye el semigrupo generado por S mediante desplazamientos y OR.
+ * @param[in] S Conjunto de generadores.
+ * @param[out] resultado Semigrupo generado por S.
+ * @return true si el conductor cabe en BITS_SEMIGRUPO y el resultado es exacto.
+ * @details
+ *   Para cada generador a se duplica el nmero de sumandos en cada paso:
+ *   R |= R << a, R |= R << 2a, R |= R << 4a, ... de modo que cada generador cuesta
+ *   O(log(BITS_SEMIGRUPO / a)) desplazamientos de unas pocas palabras. El resultado
+ *   solo es vlido si los ltimos bits contienen un bloque de m consecutivos.
+ */
+bool semigrupoDesdeGeneradores(const vector<int>& S, SemigrupoBits& resultado) {
+   uint64_t desplazado[PALABRAS_SEMIGRUPO];
+   for (int i = 0; i < PALABRAS_SEMIGRUPO; ++i)
+      resultado.bloques[i] = 0;
+   resultado.bloques[0] = 1;
+   for (int a : S) {
+      if (a <= 0)
+         continue;
+      for (long long paso = a; paso < BITS_SEMIGRUPO; paso *= 2) {
+         desplazaBits(resultado.bloques, (int)paso, desplazado);
+         for (int i = 0; i < PALABRAS_SEMIGRUPO; ++i)
+            resultado.bloques[i] |= desplazado[i];
+      }
+   }
+   actualizaInvariantes(resultado);
+   return resultado.multiplicidad < BITS_SEMIGRUPO
+       && BITS_SEMIGRUPO - 1 - resultado.frobenius >= resultado.multiplicidad;
+}
+
+/**
+ * @brief Resta, elemento a elemento, 1 en destino donde origen es no nulo (versin escalar).
+ * @param[in,out] destino Array de contadores.
+ * @param[in] origen Array de contadores que indica pertenencia (no nulo = pertenece).
+ * @param[in] n Nmero de posiciones a actualizar.
+ */
+void restaPertenenciaEscalar(uint8_t* destino, const uint8_t* origen, int n) {
+   for (int i = 0; i < n; ++i)
+      destino[i] -= (origen[i] != 0);
+}
+
+#ifdef SEMIGRUPO_SIMD_X86
+/**
+ * @brief Versin AVX2 de restaPertenenciaEscalar (32 contadores por instruccin).
+ */
+__attribute__((target("avx2")))
+void restaPertenenciaAVX2(uint8_t* destino, const uint8_t* origen, int n) {
+   const __m256i cero = _mm256_setzero_si256();
+   const __m256i uno = _mm256_set1_epi8(1);
+   int i = 0;
+   for (; i + 32 <= n; i += 32) {
+      __m256i d = _mm256_loadu_si256((const __m256i*)(destino + i));
+      __m256i o = _mm256_loadu_si256((const __m256i*)(origen + i));
+      __m256i resta = _mm256_andnot_si256(_mm256_cmpeq_epi8(o, cero), uno);
+      _mm256_storeu_si256((__m256i*)(destino + i), _mm256_sub_epi8(d, resta));
+   }
+   restaPertenenciaEscalar(destino + i, origen + i, n - i);
+}
+
+/**
+ * @brief Versin AVX-512 de restaPertenenciaEscalar (64 contadores por instruccin).
+ */
+__attribute__((target("avx512f,avx512bw")))
+void restaPertenenciaAVX512(uint8_t* destino, const uint8_t* origen, int n) {
+   const __m512i uno = _mm512_set1_epi8(1);
+   int i = 0;
+   for (; i + 64 <= n; i += 64) {
+      __m512i d = _mm512_loadu_si512((const void*)(destino + i));
+      __m512i o = _mm512_loadu_si512((const void*)(origen + i));
+      __mmask64 pertenece = _mm512_test_epi8_mask(o, o);
+      _mm512_storeu_si512((void*)(destino + i), _mm512_mask_sub_epi8(d, pertenece, d, uno));
+   }
+   restaPertenenciaEscalar(destino + i, origen + i, n - i);
+}
+#endif
+
+/**
+ * @brief Conjunto de funciones que actualizan los nmeros de descomposiciones.
+ */
+struct KernelDescomposiciones {
+   void (*resta)(uint8_t*, const uint8_t*, int);  //destino[i] -= (origen[i] != 0).
+   const char* nombre;                            //Juego de instrucciones empleado.
+};
+
+KernelDescomposiciones kernelDescomposiciones = { restaPertenenciaEscalar, "escalar" };
+
+/**
+ * @brief Selecciona el kernel de descomposiciones segn la preferencia y la CPU.
+ * @param[in] preferencia "auto", "escalar", "avx2" o "avx512".
+ * @return true si la preferencia es vlida y la CPU la admite.
+ * @details
+ *   Con "auto" se elige la variante ms ancha disponible en tiempo de ejecucin.
+ */
+bool seleccionaKernel(const string& preferencia) {
+   KernelDescomposiciones escalar = { restaPertenenciaEscalar, "escalar" };
+   if (preferencia == "escalar") {
+      kernelDescomposiciones = escalar;
+      return true;
+   }
+#ifdef SEMIGRUPO_SIMD_X86
+   __builtin_cpu_init();
+   bool tieneAVX512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+   bool tieneAVX2 = __builtin_cpu_supports("avx2");
+   KernelDescomposiciones avx512 = { restaPertenenciaAVX512, "avx512" };
+   KernelDescomposiciones avx2 = { restaPertenenciaAVX2, "avx2" };
+   if (preferencia == "avx512" || (preferencia == "auto" && tieneAVX512)) {
+      kernelDescomposiciones = avx512;
+      return tieneAVX512;
+   }
+   if (preferencia == "avx2" || (preferencia == "auto" && tieneAVX2)) {
+      kernelDescomposiciones = avx2;
+      return tieneAVX2;
+   }
+#endif
+   kernelDescomposiciones = escalar;
+   return preferencia == "auto";
+}
+
+/**
+ * @brief Semigrupo numrico representado por sus nmeros de descomposiciones.
+ * @details
+ *   descomposiciones[i] es el nmero de pares (a, b) con a <= b, a + b = i y a, b en S
+ *   (incluido el 0). As, i pertenece a S si el contador es no nulo, e i > 0 es un
+ *   generador minimal si el contador vale exactamente 1 (solo 0 + i).
+ */
+struct SemigrupoDescomposiciones {
+   uint8_t descomposiciones[BITS_SEMIGRUPO];  //Nmero de descomposiciones de 0..BITS_SEMIGRUPO-1.
+   int multiplicidad;                         //Menor elemento no nulo.
+   int frobenius;                             //Mayor entero que no pertenece (-1 para N).
+   int genero;                                //Nmero de huecos.
+};
+
+/**
+ * @brief Invariantes bsicos de un semigrupo numrico, obtenidos en una sola pasada.
+ */
+struct InvariantesSemigrupo {
+   bool finito;            //mcd de los generadores igual a 1 (complemento finito).
+   int multiplicidad;      //Menor generador no nulo.
+   int frobenius;          //Mayor entero no representable (-1 para N).
+   int conductor;          //frobenius + 1.
+   int genero;             //Nmero de enteros no representables.
+   int dimensionEmbebido;  //Nmero de generadores minimales.
+};
+
+/**
+ * @brief Calcula los invariantes a partir del conjunto de Apry respecto a la multiplicidad.
+ * @param[in] generadores Generadores positivos, distintos, ordenados y con mcd 1.
+ * @param[out] inv Invariantes; se rellenan todos los campos salvo finito.
+ * @details
+ *   w[r] es el menor elemento del semigrupo congruente con r mdulo m. Cada generador a
+ *   se aade con una vuelta de round-robin: los restos forman mcd(a, m) ciclos r -> r+a
+ *   y cada uno se recorre desde su mnimo relajando w[r+a] = min(w[r+a], w[r]+a). Si ya
+ *   antes w[a mod m] <= a, a es suma de generadores menores y no es minimal. Al final
+ *   F = max(w) - m y el gnero es la suma de (w[r] - r)/m (frmulas de Selmer).
+ *   No hay ventana: la cota de Schur (m-1)(M-1) no cabe en int con generadores de 16
+ *   bits y la ventana ocupara varios GB, mientras que w ocupa O(m) y el coste es O(km).
+ *   Si mM llega a 2^31, F y el gnero pueden no caber en int y se saturan a INT_MAX.
+ */
+void invariantesPorApery(const ConjuntoGeneradores& generadores, InvariantesSemigrupo& inv) {
+   int m = generadores.front();
+   vector<long long> w(m, -1);
+   w[0] = 0;
+
+   inv.multiplicidad = m;
+   inv.dimensionEmbebido = 1;
+   for (size_t i = 1; i < generadores.size(); ++i) {
+      int a = generadores[i];
+      int paso = a % m;
+      if (w[paso] >= 0 && w[paso] <= a)
+         continue;
+      ++inv.dimensionEmbebido;
+      int ciclos = maxCD(m, paso);
+      int longitud = m / ciclos;
+      for (int p = 0; p < ciclos; ++p) {
+         //Se empieza por el mnimo del ciclo, que ya no puede mejorar
+         int inicio = -1, q = p;
+         for (int j = 0; j < longitud; ++j) {
+            if (w[q] >= 0 && (inicio < 0 || w[q] < w[inicio]))
+               inicio = q;
+            q = (q + paso) % m;
+         }
+         if (inicio < 0)
+            continue;
+         q = inicio;
+         for (int j = 1; j < longitud; ++j) {
+            int siguiente = (q + paso) % m;
+            if (w[siguiente] < 0 || w[q] + a < w[siguiente])
+               w[siguiente] = w[q] + a;
+            q = siguiente;
+         }
+      }
+   }
+
+   long long mayor = 0, genero = 0;
+   for (int r = 1; r < m; ++r) {
+      mayor = max(mayor, w[r]);
+      genero += (w[r] - r) / m;
+   }
+   long long frobenius = mayor - m;
+   inv.frobenius = (int)min<long long>(frobenius, INT_MAX);
+   inv.conductor = (int)min<long long>(frobenius + 1, INT_MAX);
+   inv.genero = (int)min<long long>(genero, INT_MAX);
+}
+
+/**
+ * @brief Conjunto de enteros de [0, 64PALABRAS) guardado como bits de ancho fijo.
+ * @details
+ *   El ancho se fija al compilar, as que los bucles sobre las palabras se desenrollan
+ *   y el conjunto vive en la pila (o en registros) sin reservas de memoria.
+ */
+template <int PALABRAS>
+struct BitsFijos {
+   array<uint64_t, PALABRAS> bloques;
+};
+
+/**
+ * @brief Comprueba si i est en el conjunto; los enteros fuera de la ventana se dan por incluidos.
+ * @param[in] R Conjunto.
+ * @param[in] i Entero no negativo.
+ * @return true si i >= 64PALABRAS o su bit est a 1.
+ */
+template <int PALABRAS>
+inline bool contieneFijo(const BitsFijos<PALABRAS>& R, int i) {
+   if (i >= 64 * PALABRAS)
+      return true;
+   return (R.bloques[i >> 6] >> (i & 63)) & 1;
+}
+
+/**
+ * @brief Hace R |= R << k dentro de la ventana.
+ * @param[in,out] R Conjunto.
+ * @param[in] k Desplazamiento (0 < k < 64PALABRAS).
+ */
+template <int PALABRAS>
+inline void cierraDesplazamientoFijo(BitsFijos<PALABRAS>& R, int k) {
+   int palabras = k >> 6;
+   int bits = k & 63;
+   //De la palabra ms alta a la ms baja para leer los valores previos
+   for (int i = PALABRAS - 1; i >= palabras; --i) {
+      int j = i - palabras;
+      uint64_t valor = R.bloques[j] << bits;
+      if (bits != 0 && j > 0)
+         valor |= R.bloques[j - 1] >> (64 - bits);
+      R.bloques[i] |= valor;
+   }
+}
+
+/**
+ * @brief Calcula los invariantes sobre una ventana de 64PALABRAS bits.
+ * @param[in] generadores Generadores positivos, distintos, ordenados y con mcd 1.
+ * @param[in] limite Cota de Schur max((m-1)(M-1), M) de los generadores.
+ * @param[out] inv Invariantes; se rellenan todos los campos salvo finito.
+ * @return true si el resultado es exacto.
+ * @details
+ *   Los generadores se aaden de menor a mayor y el cierre bajo
+ *   cada generador se hace por desplazamientos dobles R |= R << a, R |= R << 2a, ...
+ *   Si la ventana supera la cota de Schur el resultado es exacto; si no, solo lo es
+ *   cuando la ventana termina en un bloque de m elementos consecutivos. Los generadores
+ *   que no caben solo dejan el resultado igual si ya pertenecan, que es lo que supone
+ *   contieneFijo; si no, esa comprobacin falla.
+ */
+template <int PALABRAS>
+bool invariantesPorBitsFijos(const ConjuntoGeneradores& generadores, long long limite, InvariantesSemigrupo& inv) {
+   const int BITS = 64 * PALABRAS;
+   BitsFijos<PALABRAS> R;
+   R.bloques.fill(0);
+   R.bloques[0] = 1;
+
+   inv.multiplicidad = generadores.front();
+   inv.dimensionEmbebido = 0;
+   for (int a : generadores) {
+      if (contieneFijo(R, a))
+         continue;
+      ++inv.dimensionEmbebido;
+      for (int paso = a; paso < BITS; paso *= 2)
+         cierraDesplazamientoFijo(R, paso);
+   }
+
+   inv.frobenius = -1;
+   inv.genero = 0;
+   for (int i = 0; i < PALABRAS; ++i) {
+      uint64_t huecos = ~R.bloques[i];
+      if (huecos != 0) {
+         inv.frobenius = 64 * i + 63 - __builtin_clzll(huecos);
+         inv.genero += __builtin_popcountll(huecos);
+      }
+   }
+   inv.conductor = inv.frobenius + 1;
+   return limite < BITS || BITS - 1 - inv.frobenius >= inv.multiplicidad;
+}
+
+/**
+ * @brief Calcula los invariantes con la menor ventana de bits fija que contiene el conductor.
+ * @param[in] generadores Generadores positivos, distintos, ordenados y con mcd 1.
+ * @param[out] inv Invariantes; se rellenan todos los campos salvo finito.
+ * @return true si el resultado es exacto; false si hay que recurrir a invariantesPorApery.
+ * @details
+ *   Se elige entre 64, 128, 256, 512 y 1024 bits la primera ventana mayor que la cota de
+ *   Schur, de modo que los casos pequeos, que son casi todos, se resuelven con una o
+ *   dos palabras. Si la cota no cabe en 1024 bits se prueba esa ventana igualmente,
+ *   porque el conductor real suele estar muy por debajo de la cota.
+ */
+bool invariantesPorBits(const ConjuntoGeneradores& generadores, InvariantesSemigrupo& inv) {
+   long long m = generadores.front();
+   long long M = generadores.back();
+   long long limite = max((m - 1) * (M - 1), M);
+   if (limite < 64)
+      return invariantesPorBitsFijos<1>(generadores, limite, inv);
+   if (limite < 128)
+      return invariantesPorBitsFijos<2>(generadores, limite, inv);
+   if (limite < 256)
+      return invariantesPorBitsFijos<4>(generadores, limite, inv);
+   if (limite < 512)
+      return invariantesPorBitsFijos<8>(generadores, limite, inv);
+   return invariantesPorBitsFijos<16>(generadores, limite, inv);
+}
+
+/**
+ * @brief Calcula todos los invariantes bsicos de un semigrupo en una sola pasada.
+ * @param[in] generadores Conjunto de generadores (un vector se normaliza al convertirlo).
+ * @return Invariantes; si el mcd no es 1, finito = false y el resto no tiene sentido.
+ * @details
+ *   Sustituye a las programaciones dinmicas separadas de conductor, gnero, Frobenius y
+ *   minimalidad: cada semigrupo candidato se analiza una sola vez.
+ */
+InvariantesSemigrupo calculaInvariantes(const ConjuntoGeneradores& generadores) {
+   InvariantesSemigrupo inv = {false, 0, -1, 0, 0, 0};
+   if (generadores.empty())
+      return inv;
+
+   int mcd = 0;
+   for (int s : generadores)
+      mcd = maxCD(mcd, s);
+   inv.multiplicidad = generadores[0];
+   if (mcd != 1)
+      return inv;
+
+   inv.finito = true;
+   //Si el conductor cabe en una ventana de bits fija no hace falta el vector de alcanzables
+   if (invariantesPorBits(generadores, inv))
+      return inv;
+   invariantesPorApery(generadores, inv);
+   return inv;
+}
+
+/**
+ * @brief Calcula el sistema minimal sobre una ventana fija de 64PALABRAS bits.
+ * @param[in] generadores Generadores positivos, distintos y ordenados, con el mayor
+ *            menor que 64PALABRAS.
+ * @param[out] minimal Generadores que no son suma de otros, en orden creciente.
+ * @return true si [0, max(generadores)] contiene un bloque de m elementos consecutivos.
+ */
+template <int PALABRAS>
+bool sistemaMinimalFijo(const ConjuntoGeneradores& generadores, ConjuntoGeneradores& minimal) {
+   int limite = generadores.back();
+   BitsFijos<PALABRAS> R;
+   R.bloques.fill(0);
+   R.bloques[0] = 1;
+   for (int a : generadores) {
+      if (contieneFijo(R, a))
+         continue;
+      anadeGenerador(minimal, a);
+      for (int paso = a; paso <= limite; paso *= 2)
+         cierraDesplazamientoFijo(R, paso);
+   }
+
+   int m = generadores.front();
+   int consecutivos = 0;
+   for (int i = 0; i <= limite; ++i) {
+      if (contieneFijo(R, i)) {
+         if (++consecutivos >= m)
+            return true;
+      } else {
+         consecutivos = 0;
+      }
+   }
+   return false;
+}
+
+/**
+ * @brief Calcula el sistema minimal de generadores con una pasada de bits sobre [0, max(S)].
+ * @param[in] generadores Conjunto de generadores.
+ * @param[out] minimal Generadores que no son suma de otros.
+ * @return true si la ventana [0, max(S)] contiene un bloque de m elementos consecutivos
+ *         del semigrupo (m el menor generador), es decir, si ya se alcanza el conductor.
+ * @details
+ *   Los elementos se guardan en palabras de 64 bits y los generadores se recorren de
+ *   menor a mayor. Un generador cuyo bit ya est a 1 es suma de los anteriores y se
+ *   descarta; si no, se cierra la ventana bajo l con desplazamientos dobles
+ *   R |= R << a, R |= R << 2a, ... como en semigrupoDesdeGeneradores. As se deciden
+ *   todos los generadores en la misma pasada, sin una expansin por cada uno. Si
+ *   max(S) < 1024 se usa la menor ventana fija (sistemaMinimalFijo) en lugar del vector.
+ */
+bool sistemaMinimal(const ConjuntoGeneradores& generadores, ConjuntoGeneradores& minimal) {
+   minimal = ConjuntoGeneradores();
+   if (generadores.empty())
+      return false;
+
+   int limite = generadores.back();
+   if (limite < 64)
+      return sistemaMinimalFijo<1>(generadores, minimal);
+   if (limite < 128)
+      return sistemaMinimalFijo<2>(generadores, minimal);
+   if (limite < 256)
+      return sistemaMinimalFijo<4>(generadores, minimal);
+   if (limite < 512)
+      return sistemaMinimalFijo<8>(generadores, minimal);
+   if (limite < 1024)
+      return sistemaMinimalFijo<16>(generadores, minimal);
+
+   int palabras = limite / 64 + 1;
+   vector<uint64_t> bits(palabras, 0);
+   bits[0] = 1;
+   for (int a : generadores) {
+      if ((bits[a >> 6] >> (a & 63)) & 1)
+         continue;
+      anadeGenerador(minimal, a);
+      for (long long paso = a; paso <= limite; paso *= 2) {
+         //R |= R << paso, de la palabra ms alta a la ms baja para leer los valores previos
+         int desplazamiento = (int)(paso >> 6);
+         int resto = (int)(paso & 63);
+         for (int i = palabras - 1; i >= desplazamiento; --i) {
+            int j = i - desplazamiento;
+            uint64_t valor = bits[j] << resto;
+            if (resto != 0 && j > 0)
+               valor |= bits[j - 1] >> (64 - resto);
+            bits[i] |= valor;
+         }
+      }
+   }
+
+   int m = generadores.front();
+   int consecutivos = 0;
+   for (int i = 0; i <= limite; ++i) {
+      if ((bits[i >> 6] >> (i & 63)) & 1) {
+         if (++consecutivos >= m)
+            return true;
+      } else {
+         consecutivos = 0;
+      }
+   }
+   return false;
+}
+
+/**
+ * @brief Comprueba si S es un sistema minimal de generadores de un semigrupo numrico.
+ * @param[in] S Conjunto de generadores.
+ * @return true si el mcd es 1 y ningn generador es redundante.
+ * @details
+ *   La minimalidad solo depende de [0, max(S)], as que basta con sistemaMinimal; el mcd
+ *   se comprueba aparte cuando la ventana no llega al bloque de m consecutivos.
+ */
+bool esMinimalHilbert(const ConjuntoGeneradores& S) {
+   if (S.size() == 1)
+      return true;
+   ConjuntoGeneradores minimal;
+   bool bloque = sistemaMinimal(S, minimal);
+   if (minimal.size() != S.size())
+      return false;
+   if (bloque)
+      return true;
+   int mcd = 0;
+   for (int s : minimal)
+      mcd = maxCD(mcd, s);
+   return mcd == 1;
+}
+
+/**
+ * @brief Nmero mximo de candidatos que se evalan juntos en un lote.
+ */
+const int TAMANO_LOTE = 256;
+
+/**
+ * @brief Bloque de candidatos guardado como estructura de arrays.
+ * @details
+ *   generadores[j][c] es el j-simo generador (en orden creciente) del candidato c, de
+ *   modo que el paso j de todos los candidatos lee una fila contigua. Cada candidato
+ *   tiene entre 1 y GENERADORES_EN_LINEA generadores.
+ */
+struct LoteCandidatos {
+   int cantidad = 0;                                        //Candidatos en el lote.
+   uint8_t tamanos[TAMANO_LOTE];                            //Generadores de cada candidato.
+   uint16_t generadores[GENERADORES_EN_LINEA][TAMANO_LOTE]; //Generadores por posicin.
+};
+
+/**
+ * @brief Resultados de evaluaLote, uno por candidato.
+ */
+struct ResultadosLote {
+   uint8_t mcdUno[TAMANO_LOTE];   //1 si el mcd de los generadores es 1.
+   uint8_t minimal[TAMANO_LOTE];  //1 si el mcd es 1 y ningn generador es suma de los dems.
+   uint8_t hoja[TAMANO_LOTE];     //1 si el mcd es 1 y el Frobenius supera al mayor generador.
+   int genero[TAMANO_LOTE];       //Nmero de huecos, o -1 si el mcd no es 1.
+   int frobenius[TAMANO_LOTE];    //Mayor hueco (-1 para N), o -1 si el mcd no es 1.
+};
+
+/**
+ * @brief Aade un candidato al final de un lote.
+ * @param[in,out] lote Lote con sitio libre.
+ * @param[in] S Conjunto de 1 a GENERADORES_EN_LINEA generadores.
+ */
+void anadeCandidatoLote(LoteCandidatos& lote, const ConjuntoGeneradores& S) {
+   int c = lote.cantidad++;
+   lote.tamanos[c] = (uint8_t)S.size();
+   for (size_t j = 0; j < S.size(); ++j)
+      lote.generadores[j][c] = (uint16_t)S[j];
+}
+
+/**
+ * @brief Reconstruye el conjunto de generadores de un candidato del lote.
+ * @param[in] lote Lote.
+ * @param[in] c ndice del candidato.
+ * @return Sus generadores.
+ */
+ConjuntoGeneradores candidatoDeLote(const LoteCandidatos& lote, int c) {
+   ConjuntoGeneradores S;
+   for (int j = 0; j < lote.tamanos[c]; ++j)
+      anadeGenerador(S, lote.generadores[j][c]);
+   return S;
+}
+
+/**
+ * @brief Evala parte de un lote sobre una ventana comn de 64PALABRAS bits.
+ * @param[in] lote Lote.
+ * @param[in] indices Candidatos del lote que se evalan.
+ * @param[in] n Nmero de ndices.
+ * @param[out] r Resultados de los candidatos exactos.
+ * @param[out] exacto exacto[c] = 1 si el resultado de c es vlido; si no, hay que
+ *             recalcularlo con las funciones de un solo conjunto.
+ * @details
+ *   Es invariantesPorBitsFijos con los candidatos en paralelo: sus conjuntos R se
+ *   guardan como estructura de arrays y en el paso j cada candidato decide y cierra su
+ *   j-simo generador, as que el cierre, el mcd y el recuento final recorren filas
+ *   contiguas. La exactitud se decide por candidato con la misma regla.
+ */
+template <int PALABRAS>
+void evaluaLoteFijo(const LoteCandidatos& lote, const int* indices, int n, ResultadosLote& r, uint8_t* exacto) {
+   const int BITS = 64 * PALABRAS;
+   uint64_t R[PALABRAS][TAMANO_LOTE];
+   int mcd[TAMANO_LOTE];
+   int dimension[TAMANO_LOTE];
+   int pasos = 0;
+   for (int t = 0; t < n; ++t) {
+      R[0][t] = 1;
+      for (int i = 1; i < PALABRAS; ++i)
+         R[i][t] = 0;
+      mcd[t] = 0;
+      dimension[t] = 0;
+      pasos = max(pasos, (int)lote.tamanos[indices[t]]);
+   }
+
+   for (int j = 0; j < pasos; ++j) {
+      const uint16_t* fila = lote.generadores[j];
+      for (int t = 0; t < n; ++t) {
+         int c = indices[t];
+         if (j >= lote.tamanos[c])
+            continue;
+         int a = fila[c];
+         mcd[t] = maxCD(mcd[t], a);
+         //Fuera de la ventana se da por incluido, como en contieneFijo
+         if (a >= BITS || ((R[a >> 6][t] >> (a & 63)) & 1))
+            continue;
+         ++dimension[t];
+         for (int paso = a; paso < BITS; paso *= 2) {
+            int palabras = paso >> 6;
+            int bits = paso & 63;
+            for (int i = PALABRAS - 1; i >= palabras; --i) {
+               int k = i - palabras;
+               uint64_t valor = R[k][t] << bits;
+               if (bits != 0 && k > 0)
+                  valor |= R[k - 1][t] >> (64 - bits);
+               R[i][t] |= valor;
+            }
+         }
+      }
+   }
+
+   for (int t = 0; t < n; ++t) {
+      int c = indices[t];
+      int tamano = lote.tamanos[c];
+      int m = lote.generadores[0][c];
+      int M = lote.generadores[tamano - 1][c];
+      int frobenius = -1, genero = 0;
+      for (int i = 0; i < PALABRAS; ++i) {
+         uint64_t huecos = ~R[i][t];
+         if (huecos != 0) {
+            frobenius = 64 * i + 63 - __builtin_clzll(huecos);
+            genero += __builtin_popcountll(huecos);
+         }
+      }
+      long long limite = max((long long)(m - 1) * (M - 1), (long long)M);
+      r.mcdUno[c] = mcd[t] == 1;
+      if (r.mcdUno[c]) {
+         exacto[c] = limite < BITS || BITS - 1 - frobenius >= m;
+         r.minimal[c] = dimension[t] == tamano;
+         r.genero[c] = genero;
+         r.frobenius[c] = frobenius;
+         r.hoja[c] = frobenius > M;
+      } else {
+         //Sin mcd 1 no hay semigrupo numrico, as que tampoco se marca como minimal
+         exacto[c] = 1;
+         r.minimal[c] = 0;
+         r.genero[c] = -1;
+         r.frobenius[c] = -1;
+         r.hoja[c] = 0;
+      }
+   }
+}
+
+/**
+ * @brief Calcula mcd, gnero, Frobenius, minimalidad y hoja de todos los candidatos de un lote.
+ * @param[in] lote Lote de candidatos.
+ * @param[out] r Resultados de cada candidato (ver ResultadosLote).
+ * @details
+ *   Los candidatos se reparten por la menor ventana de 64, 128, 256, 512 o 1024 bits que
+ *   supera su cota de Schur (como en invariantesPorBits) y cada grupo se evala a la vez
+ *   con evaluaLoteFijo, de modo que un candidato con cota grande no obliga a todo el lote
+ *   a usar la ventana ancha. Los candidatos cuyo resultado no es exacto en su ventana
+ *   se recalculan uno a uno.
+ */
+void evaluaLote(const LoteCandidatos& lote, ResultadosLote& r) {
+   int indices[5][TAMANO_LOTE];
+   int cuantos[5] = {0, 0, 0, 0, 0};
+   for (int c = 0; c < lote.cantidad; ++c) {
+      long long m = lote.generadores[0][c];
+      long long M = lote.generadores[lote.tamanos[c] - 1][c];
+      long long limite = max((m - 1) * (M - 1), M);
+      int grupo = limite < 64 ? 0 : limite < 128 ? 1 : limite < 256 ? 2 : limite < 512 ? 3 : 4;
+      indices[grupo][cuantos[grupo]++] = c;
+   }
+   uint8_t exacto[TAMANO_LOTE];
+   evaluaLoteFijo<1>(lote, indices[0], cuantos[0], r, exacto);
+   evaluaLoteFijo<2>(lote, indices[1], cuantos[1], r, exacto);
+   evaluaLoteFijo<4>(lote, indices[2], cuantos[2], r, exacto);
+   evaluaLoteFijo<8>(lote, indices[3], cuantos[3], r, exacto);
+   evaluaLoteFijo<16>(lote, indices[4], cuantos[4], r, exacto);
+
+   for (int c = 0; c < lote.cantidad; ++c) {
+      if (exacto[c])
+         continue;
+      ConjuntoGeneradores S = candidatoDeLote(lote, c);
+      InvariantesSemigrupo inv = calculaInvariantes(S);
+      r.mcdUno[c] = inv.finito;
+      r.minimal[c] = inv.finito && esMinimalHilbert(S);
+      r.genero[c] = inv.finito ? inv.genero : -1;
+      r.frobenius[c] = inv.finito ? inv.frobenius : -1;
+      r.hoja[c] = inv.finito && inv.frobenius > S.back();
+   }
+}
+
+/**
+ * @brief Estado de un recorrido perezoso de las combinaciones de tamao fijo.
+ * @details
+ * Sigue el orden de "puerta giratoria" (revolving door, Knuth 7.2.1.3, algoritmo R):
+ * entre dos combinaciones consecutivas slo entra un elemento y sale otro, y todas
+ * se escriben sobre el mismo bfer `combinacion`, de modo que la memoria ocupada es
+ * O(tamano) en lugar de O(C(n, tamano)).
+ */
+struct IteradorCombinaciones {
+   const vector<int>* numeros = nullptr; //elementos de los que se extraen las combinaciones
+   int tamano = 0;                       //tamao t de cada combinacin
+   vector<int> indices;                  //c[1..t] crecientes y centinela c[t+1] = n
+   vector<int> combinacion;              //combinacin actual, ordenada de menor a mayor
+   bool primera = true;                  //an no se ha visitado la primera combinacin
+   bool terminado = false;               //ya se han visitado todas las combinaciones
+};
+
+/**
+ * @brief Prepara un iterador sobre las combinaciones de `tamano` elementos de `numeros`.
+ * @param[out] it Iterador a inicializar.
+ * @param[in] numeros Vector de entrada; debe seguir vivo mientras se use el iterador.
+ * @param[in] tamano Tamao de cada combinacin (mayor o igual que 1).
+ */
+void iniciaCombinaciones(IteradorCombinaciones& it, const vector<int>& numeros, int tamano) {
+   int n = numeros.size();
+   it.numeros = &numeros;
+   it.tamano = tamano;
+   it.indices.assign(tamano + 2, 0);
+   for (int j = 1; j <= tamano; ++j)
+      it.indices[j] = j - 1;
+   it.indices[tamano + 1] = n;
+   it.combinacion.assign(tamano, 0);
+   it.primera = true;
+   it.terminado = tamano < 1 || tamano > n;
+}
+
+/**
+ * @brief Avanza a la siguiente combinacin y la deja en `it.combinacion`.
+ * @param[in,out] it Iterador de combinaciones.
+ * @return false cuando ya no quedan combinaciones.
+ * @details
+ * Pasos R3-R5 del algoritmo R: segn la paridad de t se intenta mover c[1] y, si no
+ * es posible, se busca el primer j cuyo c[j] pueda bajar o subir una posicin. Slo
+ * se reescriben en el bfer las posiciones que han cambiado.
+ */
+bool siguienteCombinacion(IteradorCombinaciones& it) {
+   if (it.terminado)
+      return false;
+   vector<int>& c = it.indices;
+   const vector<int>& numeros = *it.numeros;
+   int t = it.tamano;
+
+   if (it.primera) {
+      it.primera = false;
+      for (int j = 1; j <= t; ++j)
+         it.combinacion[j - 1] = numeros[c[j]];
+      return true;
+   }
+
+   int j;
+   bool incrementa;
+   if (t % 2 == 1) {
+      if (c[1] + 1 < c[2]) {
+         ++c[1];
+         it.combinacion[0] = numeros[c[1]];
+         return true;
+      }
+      j = 2;
+      incrementa = false;
+   }
+   else {
+      if (c[1] > 0) {
+         --c[1];
+         it.combinacion[0] = numeros[c[1]];
+         return true;
+      }
+      j = 2;
+      incrementa = true;
+   }
+
+   while (j <= t) {
+      if (!incrementa) {
+         //R4: aqu c[j] = c[j-1] + 1, se intenta bajar c[j]
+         if (c[j] >= j) {
+            c[j] = c[j - 1];
+            c[j - 1] = j - 2;
+            it.combinacion[j - 1] = numeros[c[j]];
+            it.combinacion[j - 2] = numeros[c[j - 1]];
+            return true;
+         }
+         ++j;
+      }
+      else {
+         //R5: aqu c[j-1] = j - 2, se intenta subir c[j]
+         if (c[j] + 1 < c[j + 1]) {
+            c[j - 1] = c[j];
+            ++c[j];
+            it.combinacion[j - 1] = numeros[c[j]];
+            it.combinacion[j - 2] = numeros[c[j - 1]];
+            return true;
+         }
+         ++j;
+      }
+      incrementa = !incrementa;
+   }
+   it.terminado = true;
+   return false;
+}
+
+/**
+ * @brief Lista compacta de semigrupos en formato CSR (filas comprimidas).
+ * @details
+ *   Los generadores de todos los semigrupos van seguidos en un nico array de 16 bits y
+ *   el semigrupo i ocupa valores[inicios[i]..inicios[i+1]). La clasificacin en hoja o
+ *   interno se guarda en un mapa de bits aparte. Frente a vector<vector<int>> se evita
+ *   una reserva de memoria y 24 bytes de cabecera por semigrupo, y cada valor ocupa la
+ *   mitad. Los generadores deben ser menores que 65536 y el total de valores menor
+ *   que 2^32.
+ */
+struct ListaSemigrupos {
+   vector<uint16_t> valores;                         //Generadores de todos los semigrupos, seguidos.
+   vector<uint32_t> inicios = vector<uint32_t>(1, 0); //Inicio de cada semigrupo y final del ltimo.
+   vector<uint64_t> hojas;                           //Bit i a 1 si el semigrupo i es hoja.
+};
+
+/**
+ * @brief Nmero de semigrupos de una lista.
+ * @param[in] L Lista.
+ * @return Nmero de semigrupos guardados.
+ */
+size_t numSemigrupos(const ListaSemigrupos& L) {
+   return L.inicios.size() - 1;
+}
+
+/**
+ * @brief Aade un semigrupo al final de una lista.
+ * @param[in,out] L Lista.
+ * @param[in] generadores Generadores minimales, en el orden en que se guardarn.
+ * @param[in] tamano Nmero de generadores.
+ * @param[in] hoja Si el semigrupo es hoja.
+ */
+void anadeSemigrupo(ListaSemigrupos& L, const uint16_t* generadores, size_t tamano, bool hoja) {
+   size_t i = numSemigrupos(L);
+   if (i % 64 == 0)
+      L.hojas.push_back(0);
+   if (hoja)
+      L.hojas[i / 64] |= 1ULL << (i % 64);
+   L.valores.insert(L.valores.end(), generadores, generadores + tamano);
+   L.inicios.push_back((uint32_t)L.valores.size());
+}
+
+/**
+ * @brief Aade un semigrupo al final de una lista.
+ * @param[in,out] L Lista.
+ * @param[in] S Generadores minimales.
+ * @param[in] hoja Si el semigrupo es hoja.
+ */
+void anadeSemigrupo(ListaSemigrupos& L, const ConjuntoGeneradores& S, bool hoja) {
+   anadeSemigrupo(L, S.begin(), S.size(), hoja);
+}
+
+/**
+ * @brief Indica si el semigrupo i de la lista es hoja.
+ * @param[in] L Lista.
+ * @param[in] i ndice del semigrupo.
+ * @return true si es hoja.
+ */
+bool esHojaLista(const ListaSemigrupos& L, size_t i) {
+   return (L.hojas[i / 64] >> (i % 64)) & 1;
+}
+
+/**
+ * @brief Nmero de generadores del semigrupo i de la lista.
+ * @param[in] L Lista.
+ * @param[in] i ndice del semigrupo.
+ * @return Tamao de su sistema minimal.
+ */
+size_t tamanoSemigrupo(const ListaSemigrupos& L, size_t i) {
+   return L.inicios[i + 1] - L.inicios[i];
+}
+
+/**
+ * @brief Generadores del semigrupo i de la lista, sin copiarlos.
+ * @param[in] L Lista.
+ * @param[in] i ndice del semigrupo.
+ * @return Puntero a sus tamanoSemigrupo(L, i) generadores.
+ */
+const uint16_t* generadoresSemigrupo(const ListaSemigrupos& L, size_t i) {
+   return L.valores.data() + L.inicios[i];
+}
+
+/**
+ * @brief Cuenta las hojas de una lista.
+ * @param[in] L Lista.
+ * @return Nmero de semigrupos marcados como hoja.
+ */
+uint64_t cuentaHojas(const ListaSemigrupos& L) {
+   uint64_t total = 0;
+   for (uint64_t palabra : L.hojas)
+      total += __builtin_popcountll(palabra);
+   return total;
+}
+
+/**
+ * @brief Aade al final de una lista todos los semigrupos de otra, con su clasificacin.
+ * @param[in,out] destino Lista que crece.
+ * @param[in] origen Lista que se copia.
+ */
+void concatenaListas(ListaSemigrupos& destino, const ListaSemigrupos& origen) {
+   for (size_t i = 0; i < numSemigrupos(origen); ++i) {
+      const uint16_t* g = generadoresSemigrupo(origen, i);
+      size_t n = destino.inicios.size() - 1;
+      if (n % 64 == 0)
+         destino.hojas.push_back(0);
+      if (esHojaLista(origen, i))
+         destino.hojas[n / 64] |= 1ULL << (n % 64);
+      destino.valores.insert(destino.valores.end(), g, g + tamanoSemigrupo(origen, i));
+      destino.inicios.push_back((uint32_t)destino.valores.size());
+   }
+}
+
+/**
+ * @brief Ordena una lista por nmero de generadores y, a igualdad, lexicogrficamente.
+ * @param[in,out] L Lista; cada semigrupo conserva su clasificacin.
+ * @details
+ *   Es el orden en que se han listado siempre los resultados; todos los motores lo
+ *   aplican al final, de modo que producen idntica salida. Se ordena una permutacin
+ *   de ndices comparando directamente los tramos del array de valores y despus se
+ *   reconstruye la lista en ese orden.
+ */
+void ordenaLista(ListaSemigrupos& L) {
+   size_t n = numSemigrupos(L);
+   vector<uint32_t> orden(n);
+   for (size_t i = 0; i < n; ++i)
+      orden[i] = (uint32_t)i;
+   sort(orden.begin(), orden.end(), [&L](uint32_t a, uint32_t b) {
+      size_t ta = tamanoSemigrupo(L, a), tb = tamanoSemigrupo(L, b);
+      if (ta != tb)
+         return ta < tb;
+      const uint16_t* ga = generadoresSemigrupo(L, a);
+      return lexicographical_compare(ga, ga + ta, generadoresSemigrupo(L, b), generadoresSemigrupo(L, b) + tb);
+   });
+
+   ListaSemigrupos ordenada;
+   ordenada.valores.reserve(L.valores.size());
+   ordenada.inicios.reserve(L.inicios.size());
+   ordenada.hojas.assign(L.hojas.size(), 0);
+   for (size_t k = 0; k < n; ++k) {
+      const uint16_t* g = generadoresSemigrupo(L, orden[k]);
+      if (esHojaLista(L, orden[k]))
+         ordenada.hojas[k / 64] |= 1ULL << (k % 64);
+      ordenada.valores.insert(ordenada.valores.end(), g, g + tamanoSemigrupo(L, orden[k]));
+      ordenada.inicios.push_back((uint32_t)ordenada.valores.size());
+   }
+   L.valores.swap(ordenada.valores);
+   L.inicios.swap(ordenada.inicios);
+   L.hojas.swap(ordenada.hojas);
+}
+
+/**
+ * @brief Imprime, uno por lnea como <a,b,...>, los semigrupos de la lista de una clase.
+ * @param[in] L Lista.
+ * @param[in] hojas true para imprimir las hojas y false para los internos.
+ */
+void imprimeLista(const ListaSemigrupos& L, bool hojas) {
+   for (size_t i = 0; i < numSemigrupos(L); ++i) {
+      if (esHojaLista(L, i) != hojas)
+         continue;
+      const uint16_t* g = generadoresSemigrupo(L, i);
+      size_t n = tamanoSemigrupo(L, i);
+      cout << "<";
+      for (size_t j = 0; j < n; ++j)
+         cout << g[j] << (j + 1 < n ? "," : "");
+      cout << ">\n";
+   }
+}
+
+/**
+ * @brief Compara la cantidad de semigrupos numricos internos y hojas, e imprime el resultado.
+ * @param[in] semigrupos Lista de semigrupos clasificados en internos y hojas.
+ * @details
+ * La funcin compara el nmero de semigrupos de cada clase:
+ *   - Si hay ms internos que hojas, informa que predominan los internos.
+ *   - Si hay ms hojas que internos, informa que predominan las hojas.
+ *   - Si ambos tienen igual tamao, informa que hay la misma cantidad.
+ */
+void comparaCantidades(const ListaSemigrupos& semigrupos) {
+   uint64_t hojas = cuentaHojas(semigrupos);
+   uint64_t internos = numSemigrupos(semigrupos) - hojas;
+   cout << "\nComparacion:\n";
+   if (internos > hojas)
+      cout << "Hay mas semigrupos numericos internos que hojas.\n";
+   else if (internos < hojas)
+      cout << "Hay mas semigrupos numericos hojas que internos.\n";
+   else
+      cout << "Hay igual cantidad de semigrupos numericos internos y hojas.\n";
+}
+
+/**
+ * @brief Motor de bsqueda empleado para enumerar los semigrupos de un gnero fijo.
+ */
+enum class MotorBusqueda {
+   ARBOL,         //Recorrido del rbol de semigrupos numricos.
+   COMBINACIONES, //Bsqueda exhaustiva sobre subconjuntos de {2,...,2gnero+1}.
+   PODA           //Bsqueda recursiva sobre los mismos subconjuntos, con poda.
+};
+
+/**
+ * @brief Construye la raz del rbol, el semigrupo N = <1>.
+ * @return Semigrupo con todos los enteros; i tiene i/2 + 1 descomposiciones.
+ */
+SemigrupoDescomposiciones raizArbol() {
+   SemigrupoDescomposiciones raiz;
+   for (int i = 0; i < BITS_SEMIGRUPO; ++i)
+      raiz.descomposiciones[i] = (uint8_t)(i / 2 + 1);
+   raiz.multiplicidad = 1;
+   raiz.frobenius = -1;
+   raiz.genero = 0;
+   return raiz;
+}
 
 /**
- * @brief Calcula el mximo comn divisor entre dos enteros.
- * @param[in] a Primer operando.
- * @param[in] b Segundo operando.
- * @return El mximo comn divisor de a y b.
+ * @brief Cota de los generadores minimales de cualquier semigrupo de gnero g.
+ * @param[in] genero Gnero.
+ * @return 2g + 1.
+ * @details
+ *   Si x es generador minimal y s pertenece a S con 0 < s < x, x - s es un hueco (si no,
+ *   x = s + (x - s)); as, al menos la mitad de [1, x-1] son huecos y x - 1 <= 2g. Se
+ *   alcanza en <2, 2g+1> y en <g+1, ..., 2g+1>.
  */
-int maxCD(int a, int b) {
-   while (b) {
-      a %= b;
-      swap(a, b);
-   }
-   return a;
+int cotaGeneradoresGenero(int genero) {
+   return 2 * genero + 1;
 }
 
 /**
- * @brief Genera una clave ordenada para memoizacin a partir de un vector de generadores.
- * @param[in] S Conjunto de generadores.
- * @return Cadena con los elementos de S ordenados y separados por comas.
+ * @brief Cota superior de los generadores minimales de un semigrupo.
+ * @param[in] S Semigrupo.
+ * @return min(F + m, 2g + 1), o 1 para N = <1> (cuyo Frobenius es -1).
+ * @details
+ *   Si x es un generador minimal distinto de m, x - m no pertenece a S, luego x <= F + m;
+ *   adems x <= cotaGeneradoresGenero(g), que es menor cuando m es grande.
  */
-string clave(const vector<int>& S) {
-   vector<int> copia = S;
-   sort(copia.begin(), copia.end());
-   string k = "";
-   for (int x : copia) 
-      k += to_string(x) + ",";
-   return k;
+int cotaGeneradores(const SemigrupoDescomposiciones& S) {
+   return max(min(S.frobenius + S.multiplicidad, cotaGeneradoresGenero(S.genero)), 1);
 }
 
 /**
- * @brief Calcula el conductor de un semigrupo numrico.
- * @param[in] S Conjunto de generadores.
- * @return El menor n tal que todos los enteros >= n son representables.
- * @details
- *   Se expande el conjunto de alcanzables hasta encontrar un bloque de consecutivos
- *   de longitud igual al mnimo del conjunto de generadores.
- */
-int calculaConductor(const vector<int>& S) {
-   int minS = *min_element(S.begin(), S.end());
-   int maxVal = accumulate(S.begin(), S.end(), 0);
-   vector<bool> alcanzable;
-   bool encontradoBloqueConsecutivo = false;
-   int consecutivosNecesarios = minS;
-   int conductor = maxVal;
-   while (!encontradoBloqueConsecutivo) {
-      alcanzable.assign(maxVal + 1, false);
-      alcanzable[0] = true;
-
-      for (int s : S)
-         for (int i = s; i <= maxVal; ++i)
-            alcanzable[i] = alcanzable[i] || alcanzable[i - s];
-
-      int consecutivos = 0;
-      for (int i = 0; i <= maxVal; ++i) {
-         consecutivos = alcanzable[i] ? consecutivos + 1 : 0;
-         if (consecutivos >= consecutivosNecesarios) {
-            conductor = i - consecutivosNecesarios + 1;
-            encontradoBloqueConsecutivo = true;
-            break;
-         }
-      }
-      if (!encontradoBloqueConsecutivo)
-         maxVal *= 2;
+ * @brief Obtiene el sistema minimal de generadores de un semigrupo.
+ * @param[in] S Semigrupo.
+ * @return Generadores minimales ordenados de menor a mayor.
+ */
+ConjuntoGeneradores generadoresMinimales(const SemigrupoDescomposiciones& S) {
+   ConjuntoGeneradores generadores;
+   for (int x = S.multiplicidad; x <= cotaGeneradores(S); ++x)
+      if (S.descomposiciones[x] == 1)
+         anadeGenerador(generadores, x);
+   return generadores;
+}
+
+/**
+ * @brief Construye el hijo de un nodo al quitar uno de sus generadores minimales.
+ * @param[in] S Nodo padre.
+ * @param[in] x Generador minimal mayor que el Frobenius de S.
+ * @param[out] hijo Nodo S \ {x}, cuyo Frobenius pasa a ser x.
+ * @details
+ *   Al quitar x desaparecen las descomposiciones y = x + (y - x) con y - x en S, as
+ *   que basta con restar la pertenencia de S desplazada x posiciones, en una pasada
+ *   vectorial del kernel seleccionado.
+ */
+void hijoArbol(const SemigrupoDescomposiciones& S, int x, SemigrupoDescomposiciones& hijo) {
+   memcpy(hijo.descomposiciones, S.descomposiciones, sizeof(S.descomposiciones));
+   kernelDescomposiciones.resta(hijo.descomposiciones + x, S.descomposiciones, BITS_SEMIGRUPO - x);
+   hijo.frobenius = x;
+   hijo.genero = S.genero + 1;
+   //Si se quita la multiplicidad, el siguiente elemento es x+1 (todo lo mayor que F est en S).
+   hijo.multiplicidad = (x == S.multiplicidad) ? x + 1 : S.multiplicidad;
+}
+
+/**
+ * @brief Recorre en profundidad el subrbol de S hasta el gnero buscado.
+ * @param[in] S Nodo actual.
+ * @param[in] genero Gnero objetivo.
+ * @param[out] resultado Semigrupos de gnero fijo, marcando como hoja los que no tienen descendientes.
+ * @details
+ *   Los hijos de S son S \ {x} para cada generador minimal x > F(S). Cada semigrupo
+ *   tiene un nico padre (S unin {F(S)}), por lo que se visita exactamente una vez.
+ *   Un semigrupo es hoja si no tiene generadores minimales mayores que su Frobenius.
+ */
+void recorreArbol(const SemigrupoDescomposiciones& S, int genero, ListaSemigrupos& resultado) {
+   if (S.genero == genero) {
+      ConjuntoGeneradores generadores = generadoresMinimales(S);
+      anadeSemigrupo(resultado, generadores, generadores.back() < S.frobenius);
+      return;
+   }
+   SemigrupoDescomposiciones hijo;
+   for (int x = max(S.frobenius + 1, 1); x <= cotaGeneradores(S); ++x) {
+      if (S.descomposiciones[x] != 1)
+         continue;
+      hijoArbol(S, x, hijo);
+      recorreArbol(hijo, genero, resultado);
    }
-   return conductor;
 }
 
 /**
- * @brief Calcula el gnero de un semigrupo numrico.
- * @param[in] S Conjunto de generadores.
- * @return Nmero de enteros no representables por S.
+ * @brief Nmero de semigrupos internos y hoja encontrados, sin guardarlos.
+ */
+struct RecuentoSemigrupos {
+   uint64_t internos = 0;
+   uint64_t hojas = 0;
+};
+
+/**
+ * @brief Cuenta los semigrupos del gnero buscado en el subrbol de S, sin guardarlos.
+ * @param[in] S Nodo actual.
+ * @param[in] genero Gnero objetivo.
+ * @param[in,out] recuento Internos y hojas acumulados.
  * @details
- *   Utiliza algoritmo similar al del conductor para determinar hasta dnde
- *   hay un bloque de consecutivos, y cuenta cuntos valores antes de ese
- *   conductor no son alcanzables.
+ *   Recorre el mismo rbol que recorreArbol, pero en el gnero buscado solo comprueba si
+ *   hay algn generador minimal mayor que F, sin construir el sistema minimal.
  */
-int calculaGenero(const vector<int>& S) {
-   string k = clave(S);
-   if (cacheGenero.count(k))
-      return cacheGenero[k];
+void cuentaArbol(const SemigrupoDescomposiciones& S, int genero, RecuentoSemigrupos& recuento) {
+   int cota = cotaGeneradores(S);
+   if (S.genero == genero) {
+      //Es interno si tiene algn generador minimal mayor que el Frobenius
+      bool interno = false;
+      for (int x = max(S.frobenius + 1, 1); x <= cota && !interno; ++x)
+         interno = S.descomposiciones[x] == 1;
+      if (interno)
+         ++recuento.internos;
+      else
+         ++recuento.hojas;
+      return;
+   }
+   SemigrupoDescomposiciones hijo;
+   for (int x = max(S.frobenius + 1, 1); x <= cota; ++x) {
+      if (S.descomposiciones[x] != 1)
+         continue;
+      hijoArbol(S, x, hijo);
+      cuentaArbol(hijo, genero, recuento);
+   }
+}
 
-   int minS = *min_element(S.begin(), S.end());
-   int maxVal = accumulate(S.begin(), S.end(), 0);
-   vector<bool> alcanzable;
+/**
+ * @brief Profundidad de los subrboles que un hilo recorre sin dividirlos en tareas.
+ * @details
+ *   Los nodos con gnero menor que genero - PROFUNDIDAD_SECUENCIAL se reparten como
+ *   tareas; por debajo, cada subrbol se recorre entero en el hilo que lo toma.
+ */
+const int PROFUNDIDAD_SECUENCIAL = 10;
 
-   bool encontradoBloqueConsecutivo = false;
-   int consecutivosNecesarios = minS;
-   int genero = 0;
-   while (!encontradoBloqueConsecutivo) {
-      alcanzable.assign(maxVal + 1, false);
-      alcanzable[0] = true;
-
-      for (int s : S)
-         for (int i = s; i <= maxVal; ++i)
-            alcanzable[i] = alcanzable[i] || alcanzable[i - s];
-
-      int consecutivos = 0;
-      for (int i = 0; i <= maxVal; ++i) {
-         consecutivos = alcanzable[i] ? consecutivos + 1 : 0;
-         if (consecutivos >= consecutivosNecesarios) {
-            encontradoBloqueConsecutivo = true;
-            break;
-         }
+/**
+ * @brief Cola de tareas de un hilo para el reparto con robo de trabajo.
+ * @details
+ *   El hilo propietario inserta y extrae por el final (subrboles recientes y pequeos)
+ *   y los dems hilos roban por el principio (subrboles antiguos y grandes).
+ */
+struct ColaTrabajo {
+   mutex cerrojo;
+   deque<SemigrupoDescomposiciones> tareas;
+};
+
+/**
+ * @brief Resultados acumulados por un hilo durante el recorrido paralelo.
+ */
+struct ResultadoHilo {
+   ListaSemigrupos semigrupos;
+   RecuentoSemigrupos recuento;  //Solo se usa al contar sin guardar.
+};
+
+/**
+ * @brief Obtiene una tarea de la cola propia o, si est vaca, la roba de otro hilo.
+ * @param[in,out] colas Colas de todos los hilos.
+ * @param[in] id ndice del hilo que pide trabajo.
+ * @param[out] tarea Nodo obtenido.
+ * @return true si se ha obtenido una tarea.
+ */
+bool tomaTarea(vector<ColaTrabajo>& colas, int id, SemigrupoDescomposiciones& tarea) {
+   {
+      lock_guard<mutex> bloqueo(colas[id].cerrojo);
+      if (!colas[id].tareas.empty()) {
+         tarea = colas[id].tareas.back();
+         colas[id].tareas.pop_back();
+         return true;
       }
-      if (!encontradoBloqueConsecutivo)
-         maxVal *= 2;
    }
+   int n = colas.size();
+   for (int k = 1; k < n; ++k) {
+      ColaTrabajo& victima = colas[(id + k) % n];
+      lock_guard<mutex> bloqueo(victima.cerrojo);
+      if (!victima.tareas.empty()) {
+         tarea = victima.tareas.front();
+         victima.tareas.pop_front();
+         return true;
+      }
+   }
+   return false;
+}
 
-   int conductor = 0;
-   {
-      int consecutivos = 0;
-      for (int i = 0; i <= maxVal; ++i) {
-         consecutivos = alcanzable[i] ? consecutivos + 1 : 0;
-         if (consecutivos >= consecutivosNecesarios) {
-            conductor = i - consecutivosNecesarios + 1;
-            break;
+/**
+ * @brief Bucle de un hilo del recorrido paralelo del rbol.
+ * @param[in] id ndice del hilo.
+ * @param[in] genero Gnero objetivo.
+ * @param[in] generoCorte Gnero a partir del cual los subrboles se recorren sin dividir.
+ * @param[in] soloContar Si los subrboles se cuentan con cuentaArbol en lugar de guardarse.
+ * @param[in,out] colas Colas de todos los hilos.
+ * @param[in,out] pendientes Tareas creadas y an no terminadas.
+ * @param[out] resultado Semigrupos (o recuento) encontrados por este hilo.
+ * @details
+ *   Un nodo por encima del corte se expande y sus hijos se encolan como nuevas tareas;
+ *   pendientes se incrementa antes de encolar y se decrementa al terminar la tarea,
+ *   por lo que solo llega a 0 cuando el rbol completo se ha recorrido.
+ */
+void trabajadorArbol(int id, int genero, int generoCorte, bool soloContar, vector<ColaTrabajo>& colas,
+                     atomic<long long>& pendientes, ResultadoHilo& resultado) {
+   SemigrupoDescomposiciones tarea;
+   SemigrupoDescomposiciones hijo;
+   while (pendientes.load() > 0) {
+      if (!tomaTarea(colas, id, tarea)) {
+         this_thread::yield();
+         continue;
+      }
+      if (tarea.genero >= generoCorte && soloContar)
+         cuentaArbol(tarea, genero, resultado.recuento);
+      else if (tarea.genero >= generoCorte)
+         recorreArbol(tarea, genero, resultado.semigrupos);
+      else {
+         for (int x = max(tarea.frobenius + 1, 1); x <= cotaGeneradores(tarea); ++x) {
+            if (tarea.descomposiciones[x] != 1)
+               continue;
+            hijoArbol(tarea, x, hijo);
+            pendientes.fetch_add(1);
+            lock_guard<mutex> bloqueo(colas[id].cerrojo);
+            colas[id].tareas.push_back(hijo);
          }
       }
+      pendientes.fetch_sub(1);
    }
+}
+
+/**
+ * @brief Recorre el rbol con varios hilos repartiendo subrboles con robo de trabajo.
+ * @param[in] genero Gnero objetivo.
+ * @param[in] hilos Nmero de hilos.
+ * @param[in] soloContar Si cada hilo solo cuenta los semigrupos en lugar de guardarlos.
+ * @param[out] resultados Resultado de cada hilo.
+ */
+void recorreArbolParalelo(int genero, int hilos, bool soloContar, vector<ResultadoHilo>& resultados) {
+   vector<ColaTrabajo> colas(hilos);
+   resultados.assign(hilos, ResultadoHilo());
+   atomic<long long> pendientes(1);
+   colas[0].tareas.push_back(raizArbol());
+   int generoCorte = max(genero - PROFUNDIDAD_SECUENCIAL, 0);
+
+   vector<thread> trabajadores;
+   for (int id = 0; id < hilos; ++id)
+      trabajadores.push_back(thread(trabajadorArbol, id, genero, generoCorte, soloContar,
+                                    ref(colas), ref(pendientes), ref(resultados[id])));
+   for (auto& t : trabajadores)
+      t.join();
+}
 
-   for (int i = 0; i < conductor; ++i) {
-      if (!alcanzable[i])
-         genero++;
+/**
+ * @brief Busca los semigrupos de gnero fijo recorriendo el rbol de semigrupos numricos.
+ * @param[in] genero Gnero fijo dado.
+ * @param[in] hilos Nmero de hilos (1 para el recorrido secuencial).
+ * @param[out] resultado Semigrupos numricos clasificados en internos y hojas.
+ * @details
+ *   Un semigrupo de gnero g tiene Frobenius a lo sumo 2g-1 y multiplicidad a lo sumo
+ *   g+1, as que basta con la pertenencia de los enteros hasta 3g+1 (ver GENERO_MAXIMO_ARBOL).
+ */
+void buscaPorArbol(int genero, int hilos, ListaSemigrupos& resultado) {
+   if (hilos > 1) {
+      //Los resultados de cada hilo se concatenan en orden de hilo; el orden final lo fija
+      //ordenaLista, as que la salida no depende del reparto.
+      vector<ResultadoHilo> resultados;
+      recorreArbolParalelo(genero, hilos, false, resultados);
+      for (const auto& r : resultados)
+         concatenaListas(resultado, r.semigrupos);
+   } else {
+      recorreArbol(raizArbol(), genero, resultado);
    }
-   return cacheGenero[k] = genero;
+   ordenaLista(resultado);
 }
 
 /**
- * @brief Calcula el nmero de Frobenius de un semigrupo generado por S.
- * @param[in] S Conjunto de generadores.
- * @return Mximo entero no representable (o -1 si todos son representables).
+ * @brief Cuenta los semigrupos de gnero fijo recorriendo el rbol, sin guardarlos.
+ * @param[in] genero Gnero fijo dado.
+ * @param[in] hilos Nmero de hilos (1 para el recorrido secuencial).
+ * @param[out] recuento Nmero de semigrupos internos y hoja.
  */
-int calculaFrobenius(const vector<int>& S) {
-   string k = clave(S);
-   if (cacheFrobenius.count(k))
-      return cacheFrobenius[k];
+void cuentaPorArbol(int genero, int hilos, RecuentoSemigrupos& recuento) {
+   recuento = RecuentoSemigrupos();
+   if (hilos <= 1) {
+      cuentaArbol(raizArbol(), genero, recuento);
+      return;
+   }
+   vector<ResultadoHilo> resultados;
+   recorreArbolParalelo(genero, hilos, true, resultados);
+   for (const auto& r : resultados) {
+      recuento.internos += r.recuento.internos;
+      recuento.hojas += r.recuento.hojas;
+   }
+}
 
-   int maxVal = accumulate(S.begin(), S.end(), 0);
-   vector<bool> alcanzable(maxVal + 1, false);
-   alcanzable[0] = true;
+/**
+ * @brief Histograma de un invariante separado en semigrupos internos y hojas.
+ */
+struct Histograma {
+   vector<uint64_t> internos;  //internos[v]: internos cuyo invariante vale v.
+   vector<uint64_t> hojas;     //hojas[v]: hojas cuyo invariante vale v.
+};
 
-   for (int s : S)
-      for (int i = s; i <= maxVal; ++i)
-         alcanzable[i] = alcanzable[i] || alcanzable[i - s];
+/**
+ * @brief Histogramas de los semigrupos de un mismo gnero.
+ * @details
+ *   Con gnero g, la multiplicidad y la dimensin de embebido estn en [1, g+1] y el
+ *   Frobenius en [-1, 2g-1]; este ltimo se guarda desplazado una posicin.
+ */
+struct EstadisticasGenero {
+   Histograma multiplicidad;
+   Histograma frobenius;       //ndice F + 1.
+   Histograma dimension;
+};
 
-   for (int i = maxVal; i >= 0; --i)
-      if (!alcanzable[i])
-         return cacheFrobenius[k] = i;
+/**
+ * @brief Estadsticas del recorrido del rbol hasta un gnero mximo.
+ */
+struct EstadisticasArbol {
+   int generoMaximo = 0;
+   vector<EstadisticasGenero> generos;  //generos[g] para g = 0..generoMaximo.
+};
 
-   return cacheFrobenius[k] = -1; // No existe nmero de Frobenius.
+/**
+ * @brief Reserva los histogramas vacos de los gneros 0..generoMaximo.
+ * @param[out] E Estadsticas a inicializar.
+ * @param[in] generoMaximo Mayor gnero que se recorre.
+ */
+void iniciaEstadisticas(EstadisticasArbol& E, int generoMaximo) {
+   E.generoMaximo = generoMaximo;
+   E.generos.assign(generoMaximo + 1, EstadisticasGenero());
+   for (int g = 0; g <= generoMaximo; ++g) {
+      EstadisticasGenero& G = E.generos[g];
+      for (Histograma* h : {&G.multiplicidad, &G.dimension}) {
+         h->internos.assign(g + 2, 0);
+         h->hojas.assign(g + 2, 0);
+      }
+      G.frobenius.internos.assign(2 * g + 1, 0);
+      G.frobenius.hojas.assign(2 * g + 1, 0);
+   }
 }
 
 /**
- * @brief Comprueba si S es minimal en forma expandida de Hilbert.
- * @param[in] S Conjunto de generadores.
- * @return true si ningn generador es redundante y se alcanza un bloque mnimo.
- */
-bool esMinimalHilbert(const vector<int>& S) {
-   if (S.size() == 1) return true;
-
-   int minS = *min_element(S.begin(), S.end());
-   int conductor = calculaConductor(S);
-   int limit = conductor + minS;
-
-   set<int> hilbert;
-   vector<int> cola = {0};
-   hilbert.insert(0);
-
-   while (!cola.empty()) {
-      int t = cola.back(); 
-      cola.pop_back();
-      for (int a : S) {
-         int nuevoTerm = t + a;
-         if (nuevoTerm <= limit && !hilbert.count(nuevoTerm)) {
-            hilbert.insert(nuevoTerm);
-            cola.push_back(nuevoTerm);
-         }
+ * @brief Anota un nodo del rbol en los histogramas de su gnero.
+ * @param[in,out] E Estadsticas.
+ * @param[in] S Nodo del rbol.
+ * @details
+ *   Los generadores minimales son los x de [m, F + m] con una sola descomposicin; su
+ *   nmero es la dimensin de embebido y S es hoja si el mayor es menor que F.
+ */
+void anotaEstadisticas(EstadisticasArbol& E, const SemigrupoDescomposiciones& S) {
+   int dimension = 0, mayor = 0;
+   for (int x = S.multiplicidad; x <= cotaGeneradores(S); ++x) {
+      if (S.descomposiciones[x] == 1) {
+         ++dimension;
+         mayor = x;
+      }
+   }
+   bool hoja = mayor < S.frobenius;
+   EstadisticasGenero& G = E.generos[S.genero];
+   ++(hoja ? G.multiplicidad.hojas : G.multiplicidad.internos)[S.multiplicidad];
+   ++(hoja ? G.frobenius.hojas : G.frobenius.internos)[S.frobenius + 1];
+   ++(hoja ? G.dimension.hojas : G.dimension.internos)[dimension];
+}
+
+/**
+ * @brief Suma las estadsticas de un hilo a las globales.
+ * @param[in,out] destino Estadsticas acumuladas.
+ * @param[in] origen Estadsticas de un hilo, con el mismo gnero mximo.
+ */
+void sumaEstadisticas(EstadisticasArbol& destino, const EstadisticasArbol& origen) {
+   for (int g = 0; g <= destino.generoMaximo; ++g) {
+      EstadisticasGenero& d = destino.generos[g];
+      const EstadisticasGenero& o = origen.generos[g];
+      for (size_t v = 0; v < d.multiplicidad.internos.size(); ++v) {
+         d.multiplicidad.internos[v] += o.multiplicidad.internos[v];
+         d.multiplicidad.hojas[v] += o.multiplicidad.hojas[v];
+         d.dimension.internos[v] += o.dimension.internos[v];
+         d.dimension.hojas[v] += o.dimension.hojas[v];
+      }
+      for (size_t v = 0; v < d.frobenius.internos.size(); ++v) {
+         d.frobenius.internos[v] += o.frobenius.internos[v];
+         d.frobenius.hojas[v] += o.frobenius.hojas[v];
       }
    }
+}
 
-   int consecutivos = 0;
-   int prev = -2; //el primero no se debe contar como consecutivo.
-   for (int n : hilbert) {
-      consecutivos = (n == prev + 1) ? consecutivos + 1 : 1;
-      if (consecutivos >= minS) 
-         break;
-      prev = n;
+/**
+ * @brief Recorre en profundidad el subrbol de S anotando cada nodo hasta el gnero mximo.
+ * @param[in] S Nodo actual.
+ * @param[in,out] E Estadsticas del hilo que recorre el subrbol.
+ */
+void recorreEstadisticas(const SemigrupoDescomposiciones& S, EstadisticasArbol& E) {
+   anotaEstadisticas(E, S);
+   if (S.genero == E.generoMaximo)
+      return;
+   SemigrupoDescomposiciones hijo;
+   for (int x = max(S.frobenius + 1, 1); x <= cotaGeneradores(S); ++x) {
+      if (S.descomposiciones[x] != 1)
+         continue;
+      hijoArbol(S, x, hijo);
+      recorreEstadisticas(hijo, E);
    }
-   if (consecutivos < minS) 
-      return false;
+}
 
-   //Se comprueba que ningn elemento de S puede generarse sin l mismo.
-   for (size_t i = 0; i < S.size(); ++i) {
-      vector<int> copia = S;
-      copia.erase(copia.begin() + i);
-      set<int> formaExpandida;
-      vector<int> cola = {0};
-      formaExpandida.insert(0);
-      int lim = S[i] + 1;
-      while (!cola.empty()) {
-         int t = cola.back(); 
-         cola.pop_back();
-         for (int a : copia) {
-            int nuevo = t + a;
-            if (nuevo <= lim && !formaExpandida.count(nuevo)) {
-               formaExpandida.insert(nuevo);
-               cola.push_back(nuevo);
-            }
+/**
+ * @brief Bucle de un hilo del recorrido paralelo para estadsticas.
+ * @param[in] id ndice del hilo.
+ * @param[in] generoCorte Gnero a partir del cual los subrboles se recorren sin dividir.
+ * @param[in,out] colas Colas de todos los hilos.
+ * @param[in,out] pendientes Tareas creadas y an no terminadas.
+ * @param[out] E Estadsticas propias del hilo, sin sincronizacin.
+ * @details
+ *   Es el mismo reparto con robo de trabajo que trabajadorArbol, pero los nodos por
+ *   encima del corte tambin se anotan, pues se cuentan todos los gneros.
+ */
+void trabajadorEstadisticas(int id, int generoCorte, vector<ColaTrabajo>& colas,
+                            atomic<long long>& pendientes, EstadisticasArbol& E) {
+   SemigrupoDescomposiciones tarea;
+   SemigrupoDescomposiciones hijo;
+   while (pendientes.load() > 0) {
+      if (!tomaTarea(colas, id, tarea)) {
+         this_thread::yield();
+         continue;
+      }
+      if (tarea.genero >= generoCorte)
+         recorreEstadisticas(tarea, E);
+      else {
+         anotaEstadisticas(E, tarea);
+         for (int x = max(tarea.frobenius + 1, 1); x <= cotaGeneradores(tarea); ++x) {
+            if (tarea.descomposiciones[x] != 1)
+               continue;
+            hijoArbol(tarea, x, hijo);
+            pendientes.fetch_add(1);
+            lock_guard<mutex> bloqueo(colas[id].cerrojo);
+            colas[id].tareas.push_back(hijo);
          }
       }
-      if (formaExpandida.count(S[i]))
-         return false; //El elemento puede generarse sin el mismo.
+      pendientes.fetch_sub(1);
    }
+}
 
-   //Se comprueba que todos los elementos generadores estn en la forma expandida.
-   for (int s : S) {
-      if (!hilbert.count(s))
-         return false;
+/**
+ * @brief Recorre el rbol una sola vez hasta el gnero mximo y acumula sus histogramas.
+ * @param[in] generoMaximo Mayor gnero que se recorre (a lo sumo GENERO_MAXIMO_ARBOL).
+ * @param[in] hilos Nmero de hilos.
+ * @param[out] E Estadsticas de todos los gneros 0..generoMaximo.
+ * @details
+ *   Cada hilo acumula en sus propios contadores y se suman al final, as que no hay
+ *   contencin ni se guarda ningn semigrupo.
+ */
+void calculaEstadisticas(int generoMaximo, int hilos, EstadisticasArbol& E) {
+   iniciaEstadisticas(E, generoMaximo);
+   if (hilos <= 1) {
+      recorreEstadisticas(raizArbol(), E);
+      return;
    }
 
-   return true;
+   vector<ColaTrabajo> colas(hilos);
+   vector<EstadisticasArbol> parciales(hilos);
+   for (auto& parcial : parciales)
+      iniciaEstadisticas(parcial, generoMaximo);
+   atomic<long long> pendientes(1);
+   colas[0].tareas.push_back(raizArbol());
+   int generoCorte = max(generoMaximo - PROFUNDIDAD_SECUENCIAL, 0);
+
+   vector<thread> trabajadores;
+   for (int id = 0; id < hilos; ++id)
+      trabajadores.push_back(thread(trabajadorEstadisticas, id, generoCorte,
+                                    ref(colas), ref(pendientes), ref(parciales[id])));
+   for (auto& t : trabajadores)
+      t.join();
+   for (const auto& parcial : parciales)
+      sumaEstadisticas(E, parcial);
 }
 
 /**
- * @brief Comprueba si S define una hoja
- * @param[in] S Conjunto de generadores.
- * @param[in] genero Entero que indica el gnero.
- * @return true si S es hoja, false si no.
+ * @brief Formato de salida de las estadsticas.
  */
-bool esHoja(const vector<int>& S, int genero) {
-   if (calculaGenero(S) != genero)
-      return false;
-   int f = calculaFrobenius(S);
-   if (f == -1)
-      return false;
-   int max_elem = *max_element(S.begin(), S.end());
-   return f > max_elem;
+enum class FormatoEstadisticas {
+   CSV,
+   JSON
+};
+
+/**
+ * @brief Imprime las estadsticas en CSV, una fila por gnero, invariante y valor.
+ * @param[in] E Estadsticas.
+ * @details
+ *   Columnas genero,invariante,valor,internos,hojas. La fila con invariante "total" (y
+ *   valor vaco) da n_g separado en internos y hojas; solo se imprimen los valores con
+ *   algn semigrupo.
+ */
+void imprimeEstadisticasCSV(const EstadisticasArbol& E) {
+   cout << "genero,invariante,valor,internos,hojas\n";
+   for (int g = 0; g <= E.generoMaximo; ++g) {
+      const EstadisticasGenero& G = E.generos[g];
+      uint64_t internos = 0, hojas = 0;
+      for (size_t v = 0; v < G.multiplicidad.internos.size(); ++v) {
+         internos += G.multiplicidad.internos[v];
+         hojas += G.multiplicidad.hojas[v];
+      }
+      cout << g << ",total,," << internos << "," << hojas << "\n";
+
+      const pair<const char*, const Histograma*> histogramas[] = {
+         {"multiplicidad", &G.multiplicidad}, {"frobenius", &G.frobenius}, {"dimension", &G.dimension}};
+      for (const auto& h : histogramas) {
+         int desplazamiento = (h.second == &G.frobenius) ? -1 : 0;
+         for (size_t v = 0; v < h.second->internos.size(); ++v)
+            if (h.second->internos[v] + h.second->hojas[v] > 0)
+               cout << g << "," << h.first << "," << (int)v + desplazamiento << ","
+                    << h.second->internos[v] << "," << h.second->hojas[v] << "\n";
+      }
+   }
 }
 
 /**
- * @brief Comprueba si todos los pares en S son coprimos (mcd = 1).
- * @param[in] S Conjunto de generadores.
- * @return true si mcd de cada par es 1.
- */
-bool mcdEsUno(const vector<int>& S) {
-   if (S.empty()) return false;
-   int mcd = S[0];
-   for (size_t i = 1; i < S.size(); ++i) {
-      mcd = maxCD(mcd, S[i]);
-      if (mcd == 1) 
-         return true;
+ * @brief Imprime las estadsticas en JSON, con un objeto por gnero.
+ * @param[in] E Estadsticas.
+ * @details
+ *   Cada histograma es una lista de objetos {"valor", "internos", "hojas"} con los
+ *   valores que tienen algn semigrupo.
+ */
+void imprimeEstadisticasJSON(const EstadisticasArbol& E) {
+   cout << "{\n  \"generoMaximo\": " << E.generoMaximo << ",\n  \"generos\": [\n";
+   for (int g = 0; g <= E.generoMaximo; ++g) {
+      const EstadisticasGenero& G = E.generos[g];
+      uint64_t internos = 0, hojas = 0;
+      for (size_t v = 0; v < G.multiplicidad.internos.size(); ++v) {
+         internos += G.multiplicidad.internos[v];
+         hojas += G.multiplicidad.hojas[v];
+      }
+      cout << "    {\"genero\": " << g << ", \"semigrupos\": " << internos + hojas
+           << ", \"internos\": " << internos << ", \"hojas\": " << hojas;
+
+      const pair<const char*, const Histograma*> histogramas[] = {
+         {"multiplicidad", &G.multiplicidad}, {"frobenius", &G.frobenius}, {"dimension", &G.dimension}};
+      for (const auto& h : histogramas) {
+         int desplazamiento = (h.second == &G.frobenius) ? -1 : 0;
+         cout << ",\n     \"" << h.first << "\": [";
+         bool primero = true;
+         for (size_t v = 0; v < h.second->internos.size(); ++v) {
+            if (h.second->internos[v] + h.second->hojas[v] == 0)
+               continue;
+            cout << (primero ? "" : ", ") << "{\"valor\": " << (int)v + desplazamiento
+                 << ", \"internos\": " << h.second->internos[v] << ", \"hojas\": " << h.second->hojas[v] << "}";
+            primero = false;
+         }
+         cout << "]";
+      }
+      cout << "}" << (g < E.generoMaximo ? "," : "") << "\n";
    }
-   return mcd == 1;
+   cout << "  ]\n}\n";
 }
 
 /**
- * @brief Genera todas las combinaciones de tamao fijo a partir de un conjunto de nmeros.
- * @param[out] subconjuntos Contenedor donde se almacenarn las combinaciones resultantes.
- * @param[in,out] combinacion Vector temporal que guarda la combinacin en construccin.
- * @param[in] numeros Vector de entrada con los elementos de los que se extraen las combinaciones.
- * @param[in] comienzo ndice en `numeros` desde el cual se empieza a tomar elementos.
- * @param[in] tamano Tamao objetivo de cada combinacin.
+ * @brief Prueba los subconjuntos de {2,...,2gnero+1} y guarda o cuenta los semigrupos del gnero.
+ * @param[in] genero Gnero fijo dado.
+ * @param[out] resultado Lista donde se guardan los semigrupos, o nullptr para solo contarlos.
+ * @param[in,out] recuento Internos y hojas acumulados cuando resultado es nullptr.
  * @details
- * La funcin implementa un algoritmo de backtracking:
- *   1. Si la longitud de `combinacion` alcanza `tamano`, se aade una copia a `subconjuntos`.
- *   2. En caso contrario, recorre los ndices desde `comienzo` hasta el final de `numeros`,
- *      aade cada elemento a `combinacion`, y llama recursivamente avanzando `comienzo`.
- *   3. Tras la llamada recursiva, se elimina el ltimo elemento (backtrack) para explorar
- *      otras posibilidades.
+ *   Para cada multiplicidad m <= g se prueban los conjuntos {m} unin C, con C de a lo
+ *   sumo m-1 elementos de {m+1,...,2g+1}: un sistema minimal tiene como mucho un
+ *   generador por clase de resto mdulo m y ninguno supera cotaGeneradoresGenero. La
+ *   multiplicidad g+1 slo da <g+1, ..., 2g+1>, que no se prueba aqu. Los candidatos
+ *   se analizan en lotes de TAMANO_LOTE con evaluaLote.
  */
-void generaCombinaciones(vector<vector<int>>& subconjuntos, vector<int>& combinacion, const vector<int>& numeros, int comienzo, int tamano) {
-   if (combinacion.size() == tamano) {
-      subconjuntos.push_back(combinacion);
-      return;
+void exploraCombinaciones(int genero, ListaSemigrupos* resultado, RecuentoSemigrupos& recuento) {
+   int limite = cotaGeneradoresGenero(genero);
+
+   IteradorCombinaciones it;
+   LoteCandidatos lote;
+   ResultadosLote r;
+   for (int m = 2; m <= genero; ++m) {
+      vector<int> numeros(limite - m);
+      iota(numeros.begin(), numeros.end(), m + 1);
+      for (int resto = 1; resto < m; ++resto) {
+         iniciaCombinaciones(it, numeros, resto);
+         bool quedan = true;
+         while (quedan) {
+            //Se juntan hasta TAMANO_LOTE candidatos y se analizan todos a la vez:
+            //mcd, gnero, minimalidad y Frobenius
+            lote.cantidad = 0;
+            while (lote.cantidad < TAMANO_LOTE && (quedan = siguienteCombinacion(it))) {
+               ConjuntoGeneradores candidato;
+               anadeGenerador(candidato, m);
+               for (int x : it.combinacion)
+                  anadeGenerador(candidato, x);
+               anadeCandidatoLote(lote, candidato);
+            }
+            evaluaLote(lote, r);
+            for (int c = 0; c < lote.cantidad; ++c) {
+               if (!r.mcdUno[c] || r.genero[c] != genero || !r.minimal[c])
+                  continue;
+               if (resultado == nullptr)
+                  ++(r.hoja[c] ? recuento.hojas : recuento.internos);
+               else
+                  anadeSemigrupo(*resultado, candidatoDeLote(lote, c), r.hoja[c]);
+            }
+         }
+      }
    }
-   for (int i = comienzo; i < numeros.size(); ++i) {
-      combinacion.push_back(numeros[i]);
-      generaCombinaciones(subconjuntos, combinacion, numeros, i + 1, tamano);
-      combinacion.pop_back();
+}
+
+/**
+ * @brief Busca los semigrupos de gnero fijo probando subconjuntos de {2,...,2gnero+1}.
+ * @param[in] genero Gnero fijo dado.
+ * @param[out] resultado Semigrupos numricos clasificados en internos y hojas.
+ * @details
+ *   Los candidatos salen de exploraCombinaciones; <g+1, ..., 2g+1> se aade aparte.
+ */
+void buscaPorCombinaciones(int genero, ListaSemigrupos& resultado) {
+   RecuentoSemigrupos sinUso;
+   exploraCombinaciones(genero, &resultado, sinUso);
+
+   vector<int> semigrupoExtra;
+   for (int i = genero + 1; i <= 2 * genero + 1; ++i)
+      semigrupoExtra.push_back(i);
+   anadeSemigrupo(resultado, semigrupoExtra, false);
+
+   //el iterador sigue el orden de puerta giratoria, no el lexicogrfico
+   ordenaLista(resultado);
+}
+
+/**
+ * @brief Cuenta los semigrupos de gnero fijo probando subconjuntos, sin guardarlos.
+ * @param[in] genero Gnero fijo dado.
+ * @param[out] recuento Nmero de semigrupos internos y hoja.
+ * @details
+ *   Cada candidato aceptado por evaluaLote se clasifica con los indicadores del lote,
+ *   sin copiar sus generadores a ninguna lista.
+ */
+void cuentaPorCombinaciones(int genero, RecuentoSemigrupos& recuento) {
+   recuento = RecuentoSemigrupos();
+   exploraCombinaciones(genero, nullptr, recuento);
+   //<g+1, ..., 2g+1>, que no sale de las combinaciones
+   ++recuento.internos;
+}
+
+/**
+ * @brief Contadores del motor de bsqueda con poda.
+ */
+struct ContadoresPoda {
+   uint64_t explorados = 0; //subconjuntos parciales construidos
+   uint64_t podados = 0;    //ramas descartadas sin desarrollarlas
+};
+
+/**
+ * @brief Estado de la bsqueda recursiva con poda.
+ * @details
+ *   pertenencia[p] es el semigrupo generado por los p primeros generadores elegidos,
+ *   truncado a [0, alcance]; como los generadores se aaden en orden creciente, cada
+ *   nivel se obtiene del anterior en O(alcance) y deshacer un paso es volver al nivel p.
+ *   Los candidatos llegan hasta limite, pero registraSolucionPoda necesita ver
+ *   [2g, 2g+m-1], y m <= g+1.
+ */
+struct EstadoPoda {
+   int genero = 0;
+   int limite = 0;                       //mayor candidato de la ventana
+   int alcance = 0;                      //mayor entero representado en pertenencia
+   int tamanoMaximo = 0;                 //nmero mximo de generadores
+   vector<vector<uint8_t>> pertenencia;  //conjunto alcanzable en cada profundidad
+   vector<int> huecos;                   //huecos en [1, 2g-1] en cada profundidad
+   vector<int> generadores;              //generadores elegidos hasta ahora
+   ListaSemigrupos* resultado = nullptr; //nullptr: solo se cuenta en recuento
+   RecuentoSemigrupos recuento;
+   ContadoresPoda contadores;
+};
+
+/**
+ * @brief Prepara el estado de la bsqueda con poda.
+ * @param[out] e Estado a inicializar.
+ * @param[in] genero Gnero objetivo.
+ * @param[in] limite Mayor candidato a generador.
+ * @param[in] tamanoMaximo Nmero mximo de generadores.
+ * @param[out] resultado Lista donde se guardan los semigrupos, o nullptr para solo contarlos.
+ */
+void iniciaPoda(EstadoPoda& e, int genero, int limite, int tamanoMaximo, ListaSemigrupos* resultado) {
+   e.genero = genero;
+   e.limite = limite;
+   e.alcance = max(limite, 3 * genero);
+   e.tamanoMaximo = tamanoMaximo;
+   e.pertenencia.assign(tamanoMaximo + 1, vector<uint8_t>(e.alcance + 1, 0));
+   e.pertenencia[0][0] = 1;
+   e.huecos.assign(tamanoMaximo + 1, 0);
+   e.huecos[0] = max(2 * genero - 1, 0);
+   e.generadores.clear();
+   e.resultado = resultado;
+   e.recuento = RecuentoSemigrupos();
+   e.contadores = ContadoresPoda();
+}
+
+/**
+ * @brief Aade el generador x al conjunto de la profundidad p y deja el resultado en p+1.
+ * @param[in,out] e Estado de la bsqueda.
+ * @param[in] p Profundidad actual.
+ * @param[in] x Nuevo generador, mayor que todos los anteriores.
+ * @details
+ *   Recorriendo i en orden creciente, i pertenece si ya perteneca o si i-x pertenece
+ *   (incluidos los que se acaban de aadir), lo que da todos los s + kx.
+ */
+void anadeGeneradorPoda(EstadoPoda& e, int p, int x) {
+   vector<uint8_t>& siguiente = e.pertenencia[p + 1];
+   siguiente = e.pertenencia[p];
+   int cota = 2 * e.genero - 1;
+   int nuevos = 0;
+   for (int i = x; i <= e.alcance; ++i) {
+      if (!siguiente[i] && siguiente[i - x]) {
+         siguiente[i] = 1;
+         if (i <= cota)
+            ++nuevos;
+      }
    }
+   e.huecos[p + 1] = e.huecos[p] - nuevos;
+   e.generadores.push_back(x);
 }
 
 /**
- * @brief Compara la cantidad de semigrupos numricos internos y hojas, e imprime el resultado.
- * @param[in] internos Vector de semigrupos numricos internos.
- * @param[in] hojas   Vector de semigrupos numricos que son hojas.
+ * @brief Clasifica el conjunto de la profundidad p si ya es un semigrupo del gnero pedido.
+ * @param[in,out] e Estado de la bsqueda.
+ * @param[in] p Profundidad actual.
+ * @return true si es un semigrupo de gnero g (y se ha guardado o contado), false en otro caso.
  * @details
- * La funcin compara los tamaos de los dos contenedores:
- *   - Si hay ms internos que hojas, informa que predominan los internos.
- *   - Si hay ms hojas que internos, informa que predominan las hojas.
- *   - Si ambos tienen igual tamao, informa que hay la misma cantidad.
+ *   Si [2g, 2g+m-1] est en el conjunto, todo entero mayor tambin lo est, as que no
+ *   hay huecos fuera de [1, 2g-1] y el gnero es el nmero de huecos contado; esto ya
+ *   implica que el mcd es 1.
  */
-void comparaCantidades(const vector<vector<int>>& internos, const vector<vector<int>>& hojas) {
-   cout << "\nComparacion:\n";
-   if (internos.size() > hojas.size())
-      cout << "Hay mas semigrupos numericos internos que hojas.\n";
-   else if (internos.size() < hojas.size())
-      cout << "Hay mas semigrupos numericos hojas que internos.\n";
+bool registraSolucionPoda(EstadoPoda& e, int p) {
+   const vector<uint8_t>& actual = e.pertenencia[p];
+   int m = e.generadores[0];
+   int desde = 2 * e.genero;
+   if (e.huecos[p] != e.genero || desde + m - 1 > e.alcance)
+      return false;
+   for (int i = desde; i < desde + m; ++i)
+      if (!actual[i])
+         return false;
+
+   int frobenius = desde - 1;
+   while (frobenius > 0 && actual[frobenius])
+      --frobenius;
+   bool hoja = e.generadores.back() < frobenius;
+   if (e.resultado == nullptr)
+      ++(hoja ? e.recuento.hojas : e.recuento.internos);
    else
-      cout << "Hay igual cantidad de semigrupos numericos internos y hojas.\n";
+      anadeSemigrupo(*e.resultado, e.generadores, hoja);
+   return true;
 }
 
 /**
- * @brief Encuentra e imprime todos los semigrupos internos y hojas para un gnero fijo.
- * @param genero Gnero fijo dado.
+ * @brief Desarrolla la rama actual aadiendo generadores mayores o iguales que desde.
+ * @param[in,out] e Estado de la bsqueda.
+ * @param[in] p Profundidad actual (nmero de generadores elegidos).
+ * @param[in] desde Menor candidato admisible.
+ * @details
+ *   Se poda:
+ *     - una rama que ya tiene m generadores, pues un sistema minimal no tiene dos
+ *       generadores en la misma clase de resto mdulo m;
+ *     - un candidato que ya pertenece al conjunto, pues sera representable por los
+ *       generadores menores y el sistema no sera minimal;
+ *     - un hijo con menos de g huecos en [1, 2g-1], ya que aadir generadores slo
+ *       quita huecos y un semigrupo de gnero g tiene todos sus huecos en ese intervalo;
+ *     - el resto de candidatos cuando los huecos menores que el candidato, que ya no
+ *       puede cubrir ningn generador posterior, superan g o alguno es mayor o igual
+ *       que 2g (el Frobenius sera al menos 2g).
+ *   Un semigrupo de gnero g es siempre hoja de la bsqueda: cualquier generador ms
+ *   bajara el gnero.
  */
-void encontrarSemigruposYHojas(int genero) {
-   vector<vector<int>> internos;
-   vector<vector<int>> hojas;
-
-   //se limita el espacio de bsqueda con lmite.
-   int limite = genero * 5;
-   vector<int> numeros(limite - 1);
-   iota(numeros.begin(), numeros.end(), 2);
+void exploraPoda(EstadoPoda& e, int p, int desde) {
+   if (p == e.tamanoMaximo || (p > 0 && p == e.generadores[0]))
+      return;
+   const vector<uint8_t>& actual = e.pertenencia[p];
+   int permanentes = 0;
+   for (int i = 1; i < desde && i <= e.limite; ++i)
+      if (!actual[i])
+         ++permanentes;
 
-   for (int tamano = 2; tamano <= genero; ++tamano) {
-      vector<vector<int>> subconjuntos;
-      vector<int> combinacion;
-      generaCombinaciones(subconjuntos, combinacion, numeros, 0, tamano);
+   for (int x = desde; x <= e.limite; ++x) {
+      if (permanentes > e.genero) {
+         ++e.contadores.podados;
+         break;
+      }
+      if (actual[x]) {
+         ++e.contadores.podados;
+         continue;
+      }
 
-      for (const auto& subconjunto : subconjuntos) {
-         if (!mcdEsUno(subconjunto))
-            continue;
-         if (calculaGenero(subconjunto) != genero)
-            continue;
-         if (!esMinimalHilbert(subconjunto))
-            continue;
+      ++e.contadores.explorados;
+      anadeGeneradorPoda(e, p, x);
+      if (e.huecos[p + 1] < e.genero)
+         ++e.contadores.podados;
+      else if (!registraSolucionPoda(e, p + 1))
+         exploraPoda(e, p + 1, x + 1);
+      e.generadores.pop_back();
 
-         if (esHoja(subconjunto, genero))
-            hojas.push_back(subconjunto);
-         else
-            internos.push_back(subconjunto);
+      //x queda como hueco para los candidatos siguientes
+      ++permanentes;
+      if (x >= 2 * e.genero) {
+         ++e.contadores.podados;
+         break;
       }
    }
-    
+}
+
+/**
+ * @brief Busca los semigrupos de gnero fijo con una bsqueda recursiva con poda.
+ * @param[in] genero Gnero fijo dado.
+ * @param[out] resultado Semigrupos numricos clasificados en internos y hojas.
+ * @param[out] contadores Nodos explorados y podados.
+ * @details
+ *   Recorre los mismos subconjuntos de {2,...,2gnero+1} que buscaPorCombinaciones,
+ *   pero en orden creciente y manteniendo el conjunto
+ *   alcanzable de forma incremental, de modo que las ramas intiles se cortan en cuanto
+ *   aparecen (ver exploraPoda). Los sistemas obtenidos son minimales por construccin.
+ */
+void buscaPorPoda(int genero, ListaSemigrupos& resultado, ContadoresPoda& contadores) {
+   EstadoPoda estado;
+   iniciaPoda(estado, genero, cotaGeneradoresGenero(genero), genero, &resultado);
+   exploraPoda(estado, 0, 2);
+   contadores = estado.contadores;
+
    vector<int> semigrupoExtra;
    for (int i = genero + 1; i <= 2 * genero + 1; ++i)
       semigrupoExtra.push_back(i);
-   internos.push_back(semigrupoExtra);
+   anadeSemigrupo(resultado, semigrupoExtra, false);
+
+   ordenaLista(resultado);
+}
+
+/**
+ * @brief Cuenta los semigrupos de gnero fijo con la bsqueda con poda, sin guardarlos.
+ * @param[in] genero Gnero fijo dado.
+ * @param[out] recuento Nmero de semigrupos internos y hoja.
+ * @param[out] contadores Nodos explorados y podados.
+ */
+void cuentaPorPoda(int genero, RecuentoSemigrupos& recuento, ContadoresPoda& contadores) {
+   EstadoPoda estado;
+   //Sin lista, registraSolucionPoda solo cuenta
+   iniciaPoda(estado, genero, cotaGeneradoresGenero(genero), genero, nullptr);
+   exploraPoda(estado, 0, 2);
+   contadores = estado.contadores;
+   recuento = estado.recuento;
+   //<g+1, ..., 2g+1>, que la bsqueda no alcanza por tener g+1 generadores
+   ++recuento.internos;
+}
+
+/**
+ * @brief Encuentra e imprime todos los semigrupos internos y hojas para un gnero fijo.
+ * @param genero Gnero fijo dado.
+ * @param motor Motor de bsqueda a emplear.
+ * @param hilos Nmero de hilos para el recorrido del rbol.
+ */
+void encontrarSemigruposYHojas(int genero, MotorBusqueda motor, int hilos) {
+   ListaSemigrupos semigrupos;
+   ContadoresPoda contadores;
+
+   if (motor == MotorBusqueda::ARBOL)
+      buscaPorArbol(genero, hilos, semigrupos);
+   else if (motor == MotorBusqueda::PODA)
+      buscaPorPoda(genero, semigrupos, contadores);
+   else
+      buscaPorCombinaciones(genero, semigrupos);
 
    cout << "Semigrupos numericos internos:\n";
-   for (const auto& s : internos) {
-      cout << "<";
-      for (size_t i = 0; i < s.size(); ++i)
-         cout << s[i] << (i < s.size() - 1 ? "," : "");
-      cout << ">\n";
-   }
+   imprimeLista(semigrupos, false);
 
    cout << "\nSemigrupos numericos hoja:\n";
-   for (const auto& h : hojas) {
-      cout << "<";
-      for (size_t i = 0; i < h.size(); ++i)
-         cout << h[i] << (i < h.size() - 1 ? "," : "");
-      cout << ">\n";
-   }
+   imprimeLista(semigrupos, true);
     
-   comparaCantidades(internos, hojas);
+   comparaCantidades(semigrupos);
+   if (motor == MotorBusqueda::PODA)
+      cout << "Nodos explorados: " << contadores.explorados << ", podados: " << contadores.podados << "\n";
+}
+
+/**
+ * @brief Cuenta los semigrupos numricos internos y hoja de gnero fijo e imprime solo los totales.
+ * @param[in] genero Gnero fijo dado.
+ * @param[in] motor Motor de bsqueda a emplear.
+ * @param[in] hilos Nmero de hilos para el recorrido del rbol.
+ * @details
+ *   Ningn motor construye ni imprime los sistemas de generadores.
+ */
+void contarSemigruposYHojas(int genero, MotorBusqueda motor, int hilos) {
+   RecuentoSemigrupos recuento;
+   ContadoresPoda contadores;
+
+   if (motor == MotorBusqueda::ARBOL)
+      cuentaPorArbol(genero, hilos, recuento);
+   else if (motor == MotorBusqueda::PODA)
+      cuentaPorPoda(genero, recuento, contadores);
+   else
+      cuentaPorCombinaciones(genero, recuento);
+
+   cout << "Semigrupos numericos internos: " << recuento.internos << "\n";
+   cout << "Semigrupos numericos hoja: " << recuento.hojas << "\n";
+   if (motor == MotorBusqueda::PODA)
+      cout << "Nodos explorados: " << contadores.explorados << ", podados: " << contadores.podados << "\n";
 }
 
 /**
  * @brief Funcin principal: lee el gnero dado por el usuario, realiza los clculos e imprime los resultados y el tiempo.
+ * @param[in] argc Nmero de argumentos.
+ * @param[in] argv Argumentos; admite --motor=arbol (por defecto), combinaciones o poda,
+ *                 --simd=auto (por defecto), escalar, avx2 o avx512 y --hilos=N (por defecto,
+ *                 los hilos hardware disponibles), --estadisticas=G con --formato=csv (por
+ *                 defecto) o json y --solo-contar.
  * @return 0 si xito, 1 si error en entrada.
  */
-int main() {
+int main(int argc, char* argv[]) {
+   MotorBusqueda motor = MotorBusqueda::ARBOL;
+   string simd = "auto";
+   int hilos = max((int)thread::hardware_concurrency(), 1);
+   int generoEstadisticas = -1;
+   bool soloContar = false;
+   FormatoEstadisticas formato = FormatoEstadisticas::CSV;
+   for (int i = 1; i < argc; ++i) {
+      string opcion = argv[i];
+      if (opcion == "--motor=arbol")
+         motor = MotorBusqueda::ARBOL;
+      else if (opcion == "--motor=combinaciones")
+         motor = MotorBusqueda::COMBINACIONES;
+      else if (opcion == "--motor=poda")
+         motor = MotorBusqueda::PODA;
+      else if (opcion.compare(0, 7, "--simd=") == 0)
+         simd = opcion.substr(7);
+      else if (regex_match(opcion, regex("^--hilos=[1-9][0-9]{0,3}$")))
+         hilos = stoi(opcion.substr(8));
+      else if (regex_match(opcion, regex("^--estadisticas=[0-9]{1,2}$")))
+         generoEstadisticas = stoi(opcion.substr(15));
+      else if (opcion == "--solo-contar")
+         soloContar = true;
+      else if (opcion == "--formato=csv")
+         formato = FormatoEstadisticas::CSV;
+      else if (opcion == "--formato=json")
+         formato = FormatoEstadisticas::JSON;
+      else {
+         cout << "Opcion no valida: " << opcion << ". Usa --motor=arbol|combinaciones|poda, --simd=auto|escalar|avx2|avx512,"
+              << " --hilos=N, --estadisticas=G, --formato=csv|json y --solo-contar." << endl;
+         return 1;
+      }
+   }
+
+   if (!seleccionaKernel(simd)) {
+      cout << "El juego de instrucciones '" << simd << "' no es valido o no esta disponible en esta CPU." << endl;
+      return 1;
+   }
+
+   //Modo estadsticas: no se pide el gnero y solo se escribe el CSV o el JSON
+   if (generoEstadisticas >= 0) {
+      if (generoEstadisticas > GENERO_MAXIMO_ARBOL) {
+         cout << "El recorrido del arbol admite generos hasta " << GENERO_MAXIMO_ARBOL << "." << endl;
+         return 1;
+      }
+      EstadisticasArbol estadisticas;
+      calculaEstadisticas(generoEstadisticas, hilos, estadisticas);
+      if (formato == FormatoEstadisticas::JSON)
+         imprimeEstadisticasJSON(estadisticas);
+      else
+         imprimeEstadisticasCSV(estadisticas);
+      return 0;
+   }
+
    int genero;
    cout << "Introduce el genero: ";
     
@@ -407,7 +2137,16 @@ int main() {
       return 1;
    }
     
+   if (motor == MotorBusqueda::ARBOL && genero > GENERO_MAXIMO_ARBOL) {
+      cout << "El recorrido del arbol admite generos hasta " << GENERO_MAXIMO_ARBOL << "." << endl;
+      return 1;
+   }
+
    //Condicin por defecto si el usuario introduce 0 como gnero.
+   if (genero == 0 && soloContar) {
+      cout << "Semigrupos numericos internos: 1\nSemigrupos numericos hoja: 0\n";
+      return 0;
+   }
    if (genero == 0) {
       cout << "Semigrupos numericos internos:\n";
       cout << "<1>\n";
@@ -419,7 +2158,10 @@ int main() {
    cout << "Calculando semigrupos numericos internos y hojas...\n";
     
    auto inicio = chrono::high_resolution_clock::now();
-   encontrarSemigruposYHojas(genero);
+   if (soloContar)
+      contarSemigruposYHojas(genero, motor, hilos);
+   else
+      encontrarSemigruposYHojas(genero, motor, hilos);
    auto fin = chrono::high_resolution_clock::now();
     
    auto duracion = chrono::duration_cast<chrono::seconds>(fin - inicio).count();
@@ -11,15 +11,17 @@
 #define ALGORITMO_GENERO_FIJO_HPP
 
 #include <vector>
+#include <array>
 #include <string>
 #include <unordered_map>
 #include <set>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <atomic>
 
 namespace semigrupo {
 
-extern std::unordered_map<std::string, int> cacheGenero;
-extern std::unordered_map<std::string, int> cacheFrobenius;
-
 /**
  * @brief Calcula el mximo comn divisor entre dos enteros.
  * @param a Primer operando.
@@ -29,82 +31,762 @@ extern std::unordered_map<std::string, int> cacheFrobenius;
 int maxCD(int a, int b);
 
 /**
- * @brief Genera una clave ordenada para memoizacin a partir de un vector de generadores.
- * @param S Conjunto de generadores.
- * @return Cadena con los elementos de S ordenados y separados por comas.
+ * @brief Nmero de generadores que un ConjuntoGeneradores guarda sin memoria dinmica.
  */
-std::string clave(const std::vector<int>& S);
+const int GENERADORES_EN_LINEA = 32;
 
 /**
- * @brief Calcula el conductor de un semigrupo numrico.
- * @param S Conjunto de generadores.
- * @return El menor n tal que todos los enteros >= n son representables.
+ * @brief Conjunto ordenado de generadores positivos y distintos, con hasta
+ *        GENERADORES_EN_LINEA guardados en lnea (16 bits) y el resto en memoria dinmica.
+ *        Se construye implcitamente desde un std::vector<int> en cualquier orden.
  */
-int calculaConductor(const std::vector<int>& S);
+struct ConjuntoGeneradores {
+    uint16_t enLinea[GENERADORES_EN_LINEA] = {};  //Generadores, si caben.
+    std::vector<uint16_t> desbordados;            //Todos los generadores, si no caben.
+    int tamano = 0;                               //Nmero de generadores.
+
+    ConjuntoGeneradores() {}
+    ConjuntoGeneradores(const std::vector<int>& S);
+
+    const uint16_t* begin() const;
+    const uint16_t* end() const;
+    size_t size() const;
+    bool empty() const;
+    int operator[](size_t i) const;
+    int front() const;
+    int back() const;
+};
 
 /**
- * @brief Calcula el gnero de un semigrupo numrico.
- * @param S Conjunto de generadores.
- * @return Nmero de enteros no representables por S.
+ * @brief Aade un generador mayor que todos los del conjunto.
+ * @param G Conjunto.
+ * @param x Nuevo generador.
+ */
+void anadeGenerador(ConjuntoGeneradores& G, int x);
+
+/**
+ * @brief Inserta un generador en su posicin, si no estaba ya.
+ * @param G Conjunto.
+ * @param x Generador positivo.
  */
-int calculaGenero(const std::vector<int>& S);
+void insertaGenerador(ConjuntoGeneradores& G, int x);
 
 /**
- * @brief Calcula el nmero de Frobenius de un semigrupo generado por S.
+ * @brief Nmero de enteros cuya pertenencia guarda un SemigrupoBits.
+ */
+const int BITS_SEMIGRUPO = 256;
+const int PALABRAS_SEMIGRUPO = BITS_SEMIGRUPO / 64;
+
+/**
+ * @brief Mayor gnero alcanzable por el recorrido del rbol con SemigrupoBits.
+ */
+const int GENERO_MAXIMO_ARBOL = (BITS_SEMIGRUPO - 2) / 3;
+
+/**
+ * @brief Semigrupo numrico representado por un array de bits de ancho fijo.
+ */
+struct SemigrupoBits {
+    uint64_t bloques[PALABRAS_SEMIGRUPO];  //Pertenencia de 0..BITS_SEMIGRUPO-1.
+    int multiplicidad;                     //Menor elemento no nulo.
+    int frobenius;                         //Mayor entero que no pertenece (-1 para N).
+    int genero;                            //Nmero de huecos.
+};
+
+/**
+ * @brief Comprueba si un entero pertenece al semigrupo.
+ * @param S Semigrupo.
+ * @param i Entero no negativo.
+ * @return true si i est en S.
+ */
+bool pertenece(const SemigrupoBits& S, int i);
+
+/**
+ * @brief Desplaza un array de bits k posiciones hacia los ndices mayores.
+ * @param origen Array de PALABRAS_SEMIGRUPO palabras.
+ * @param k Desplazamiento (k >= 0).
+ * @param destino Resultado desplazado.
+ */
+void desplazaBits(const uint64_t* origen, int k, uint64_t* destino);
+
+/**
+ * @brief Recalcula multiplicidad, Frobenius y gnero a partir de los bits.
+ * @param S Semigrupo cuyos bloques ya estn rellenos.
+ */
+void actualizaInvariantes(SemigrupoBits& S);
+
+/**
+ * @brief Construye el semigrupo generado por S mediante desplazamientos y OR.
  * @param S Conjunto de generadores.
- * @return Mximo entero no representable (o -1 si todos son representables).
+ * @param resultado Semigrupo generado por S.
+ * @return true si el conductor cabe en BITS_SEMIGRUPO y el resultado es exacto.
+ */
+bool semigrupoDesdeGeneradores(const std::vector<int>& S, SemigrupoBits& resultado);
+
+/**
+ * @brief Resta 1 en destino donde origen es no nulo (versin escalar).
+ * @param destino Array de contadores.
+ * @param origen Array de contadores que indica pertenencia.
+ * @param n Nmero de posiciones a actualizar.
  */
-int calculaFrobenius(const std::vector<int>& S);
+void restaPertenenciaEscalar(uint8_t* destino, const uint8_t* origen, int n);
+
+/**
+ * @brief Conjunto de funciones que actualizan los nmeros de descomposiciones.
+ */
+struct KernelDescomposiciones {
+    void (*resta)(uint8_t*, const uint8_t*, int);  //destino[i] -= (origen[i] != 0).
+    const char* nombre;                            //Juego de instrucciones empleado.
+};
+
+extern KernelDescomposiciones kernelDescomposiciones;
+
+/**
+ * @brief Selecciona el kernel de descomposiciones segn la preferencia y la CPU.
+ * @param preferencia "auto", "escalar", "avx2" o "avx512".
+ * @return true si la preferencia es vlida y la CPU la admite.
+ */
+bool seleccionaKernel(const std::string& preferencia);
+
+/**
+ * @brief Semigrupo numrico representado por sus nmeros de descomposiciones.
+ */
+struct SemigrupoDescomposiciones {
+    uint8_t descomposiciones[BITS_SEMIGRUPO];  //Nmero de descomposiciones de 0..BITS_SEMIGRUPO-1.
+    int multiplicidad;                         //Menor elemento no nulo.
+    int frobenius;                             //Mayor entero que no pertenece (-1 para N).
+    int genero;                                //Nmero de huecos.
+};
+
+/**
+ * @brief Invariantes bsicos de un semigrupo numrico, calculados en una sola pasada.
+ */
+struct InvariantesSemigrupo {
+    bool finito;            //mcd de los generadores igual a 1 (complemento finito).
+    int multiplicidad;      //Menor generador no nulo.
+    int frobenius;          //Mayor entero no representable (-1 para N).
+    int conductor;          //frobenius + 1.
+    int genero;             //Nmero de enteros no representables.
+    int dimensionEmbebido;  //Nmero de generadores minimales.
+};
+
+/**
+ * @brief Calcula los invariantes a partir de Ap(S, m), con O(m) memoria y sin ventana,
+ *        as que no depende de la cota de Schur (m-1)(M-1).
+ * @param generadores Generadores positivos, distintos, ordenados y con mcd 1.
+ * @param inv Invariantes; se rellenan todos los campos salvo finito.
+ */
+void invariantesPorApery(const ConjuntoGeneradores& generadores, InvariantesSemigrupo& inv);
+
+/**
+ * @brief Conjunto de enteros de [0, 64PALABRAS) guardado como bits de ancho fijo,
+ *        sin reservas de memoria.
+ */
+template <int PALABRAS>
+struct BitsFijos {
+    std::array<uint64_t, PALABRAS> bloques;
+};
+
+/**
+ * @brief Comprueba si i est en el conjunto; los enteros fuera de la ventana se dan por incluidos.
+ * @param R Conjunto.
+ * @param i Entero no negativo.
+ * @return true si i >= 64PALABRAS o su bit est a 1.
+ */
+template <int PALABRAS>
+bool contieneFijo(const BitsFijos<PALABRAS>& R, int i);
+
+/**
+ * @brief Hace R |= R << k dentro de la ventana.
+ * @param R Conjunto.
+ * @param k Desplazamiento (0 < k < 64PALABRAS).
+ */
+template <int PALABRAS>
+void cierraDesplazamientoFijo(BitsFijos<PALABRAS>& R, int k);
+
+/**
+ * @brief Calcula los invariantes sobre una ventana de 64PALABRAS bits.
+ * @param generadores Generadores positivos, distintos, ordenados y con mcd 1.
+ * @param limite Cota de Schur max((m-1)(M-1), M) de los generadores.
+ * @param inv Invariantes; se rellenan todos los campos salvo finito.
+ * @return true si la ventana supera la cota o termina en un bloque de m elementos consecutivos.
+ */
+template <int PALABRAS>
+bool invariantesPorBitsFijos(const ConjuntoGeneradores& generadores, long long limite, InvariantesSemigrupo& inv);
+
+/**
+ * @brief Calcula los invariantes con la menor ventana de bits fija (64 a 1024 bits) que
+ *        supera la cota de Schur, o con la de 1024 si ninguna la supera.
+ * @param generadores Generadores positivos, distintos, ordenados y con mcd 1.
+ * @param inv Invariantes; se rellenan todos los campos salvo finito.
+ * @return true si el resultado es exacto; false si hay que usar invariantesPorApery.
+ */
+bool invariantesPorBits(const ConjuntoGeneradores& generadores, InvariantesSemigrupo& inv);
+
+/**
+ * @brief Calcula todos los invariantes bsicos de un semigrupo en una sola pasada.
+ * @param generadores Conjunto de generadores.
+ * @return Invariantes; finito = false si el mcd no es 1.
+ */
+InvariantesSemigrupo calculaInvariantes(const ConjuntoGeneradores& generadores);
+
+/**
+ * @brief Calcula el sistema minimal sobre una ventana fija de 64PALABRAS bits.
+ * @param generadores Generadores positivos, distintos y ordenados, con el mayor menor
+ *        que 64PALABRAS.
+ * @param minimal Generadores que no son suma de otros, en orden creciente.
+ * @return true si [0, max(generadores)] contiene un bloque de m elementos consecutivos.
+ */
+template <int PALABRAS>
+bool sistemaMinimalFijo(const ConjuntoGeneradores& generadores, ConjuntoGeneradores& minimal);
+
+/**
+ * @brief Calcula el sistema minimal de generadores con una pasada de bits sobre [0, max(S)].
+ * @param generadores Conjunto de generadores.
+ * @param minimal Generadores que no son suma de otros.
+ * @return true si la ventana contiene un bloque de m elementos consecutivos del semigrupo.
+ */
+bool sistemaMinimal(const ConjuntoGeneradores& generadores, ConjuntoGeneradores& minimal);
 
 /**
  * @brief Comprueba si S es minimal en forma expandida de Hilbert.
  * @param S Conjunto de generadores.
- * @return true si ningn generador es redundante y se alcanza un bloque mnimo.
+ * @return true si ningn generador es redundante (dimensin de embebido igual a |S|).
  */
-bool esMinimalHilbert(const std::vector<int>& S);
+bool esMinimalHilbert(const ConjuntoGeneradores& S);
 
 /**
- * @brief Comprueba si S define una hoja.
- * @param S Conjunto de generadores.
- * @param genero Gnero fijo.
- * @return true si S es hoja, false si no.
+ * @brief Nmero mximo de candidatos que se evalan juntos en un lote.
  */
-bool esHoja(const std::vector<int>& S, int genero);
+const int TAMANO_LOTE = 256;
 
 /**
- * @brief Comprueba si todos los pares en S son coprimos (mcd = 1).
- * @param S Conjunto de generadores.
- * @return true si mcd de cada par es 1.
+ * @brief Bloque de candidatos guardado como estructura de arrays: generadores[j][c] es el
+ *        j-simo generador (en orden creciente) del candidato c.
+ */
+struct LoteCandidatos {
+    int cantidad = 0;                                        //Candidatos en el lote.
+    uint8_t tamanos[TAMANO_LOTE];                            //Generadores de cada candidato.
+    uint16_t generadores[GENERADORES_EN_LINEA][TAMANO_LOTE]; //Generadores por posicin.
+};
+
+/**
+ * @brief Resultados de evaluaLote, uno por candidato.
+ */
+struct ResultadosLote {
+    uint8_t mcdUno[TAMANO_LOTE];   //1 si el mcd de los generadores es 1.
+    uint8_t minimal[TAMANO_LOTE];  //1 si el mcd es 1 y ningn generador es suma de los dems.
+    uint8_t hoja[TAMANO_LOTE];     //1 si el mcd es 1 y el Frobenius supera al mayor generador.
+    int genero[TAMANO_LOTE];       //Nmero de huecos, o -1 si el mcd no es 1.
+    int frobenius[TAMANO_LOTE];    //Mayor hueco (-1 para N), o -1 si el mcd no es 1.
+};
+
+/**
+ * @brief Aade un candidato al final de un lote.
+ * @param lote Lote con sitio libre.
+ * @param S Conjunto de 1 a GENERADORES_EN_LINEA generadores.
+ */
+void anadeCandidatoLote(LoteCandidatos& lote, const ConjuntoGeneradores& S);
+
+/**
+ * @brief Reconstruye el conjunto de generadores de un candidato del lote.
+ * @param lote Lote.
+ * @param c ndice del candidato.
+ * @return Sus generadores.
+ */
+ConjuntoGeneradores candidatoDeLote(const LoteCandidatos& lote, int c);
+
+/**
+ * @brief Evala a la vez los candidatos indicados de un lote sobre una ventana de
+ *        64PALABRAS bits, con los conjuntos alcanzables como estructura de arrays.
+ * @param lote Lote.
+ * @param indices Candidatos que se evalan.
+ * @param n Nmero de ndices.
+ * @param r Resultados de los candidatos exactos.
+ * @param exacto exacto[c] = 1 si el resultado de c es vlido en la ventana.
+ */
+template <int PALABRAS>
+void evaluaLoteFijo(const LoteCandidatos& lote, const int* indices, int n, ResultadosLote& r, uint8_t* exacto);
+
+/**
+ * @brief Calcula mcd, gnero, Frobenius, minimalidad y hoja de todos los candidatos de
+ *        un lote, agrupndolos por ventana de bits y recalculando uno a uno los que no
+ *        son exactos en ella.
+ * @param lote Lote de candidatos.
+ * @param r Resultados de cada candidato (ver ResultadosLote).
+ */
+void evaluaLote(const LoteCandidatos& lote, ResultadosLote& r);
+
+/**
+ * @brief Estado de un recorrido perezoso (orden de puerta giratoria) de las
+ *        combinaciones de tamao fijo, reutilizando un nico bfer.
+ */
+struct IteradorCombinaciones {
+    const std::vector<int>* numeros = nullptr;
+    int tamano = 0;
+    std::vector<int> indices;
+    std::vector<int> combinacion;
+    bool primera = true;
+    bool terminado = false;
+};
+
+/**
+ * @brief Prepara un iterador sobre las combinaciones de `tamano` elementos de `numeros`.
+ * @param it Iterador a inicializar.
+ * @param numeros Vector de entrada; debe seguir vivo mientras se use el iterador.
+ * @param tamano Tamao de cada combinacin.
+ */
+void iniciaCombinaciones(IteradorCombinaciones& it, const std::vector<int>& numeros, int tamano);
+
+/**
+ * @brief Avanza a la siguiente combinacin y la deja en `it.combinacion`.
+ * @param it Iterador de combinaciones.
+ * @return false cuando ya no quedan combinaciones.
+ */
+bool siguienteCombinacion(IteradorCombinaciones& it);
+
+/**
+ * @brief Lista compacta de semigrupos en formato CSR (filas comprimidas).
+ * @details
+ *   Los generadores de todos los semigrupos van seguidos en un nico array de 16 bits y
+ *   el semigrupo i ocupa valores[inicios[i]..inicios[i+1]). La clasificacin en hoja o
+ *   interno se guarda en un mapa de bits aparte.
+ */
+struct ListaSemigrupos {
+    std::vector<uint16_t> valores;                               //Generadores de todos los semigrupos, seguidos.
+    std::vector<uint32_t> inicios = std::vector<uint32_t>(1, 0); //Inicio de cada semigrupo y final del ltimo.
+    std::vector<uint64_t> hojas;                                 //Bit i a 1 si el semigrupo i es hoja.
+};
+
+/**
+ * @brief Nmero de semigrupos de una lista.
+ * @param L Lista.
+ * @return Nmero de semigrupos guardados.
+ */
+size_t numSemigrupos(const ListaSemigrupos& L);
+
+/**
+ * @brief Aade un semigrupo al final de una lista.
+ * @param L Lista.
+ * @param generadores Generadores minimales, en el orden en que se guardarn.
+ * @param tamano Nmero de generadores.
+ * @param hoja Si el semigrupo es hoja.
+ */
+void anadeSemigrupo(ListaSemigrupos& L, const uint16_t* generadores, size_t tamano, bool hoja);
+
+/**
+ * @brief Aade un semigrupo al final de una lista.
+ * @param L Lista.
+ * @param S Generadores minimales.
+ * @param hoja Si el semigrupo es hoja.
+ */
+void anadeSemigrupo(ListaSemigrupos& L, const ConjuntoGeneradores& S, bool hoja);
+
+/**
+ * @brief Indica si el semigrupo i de la lista es hoja.
+ * @param L Lista.
+ * @param i ndice del semigrupo.
+ * @return true si es hoja.
+ */
+bool esHojaLista(const ListaSemigrupos& L, size_t i);
+
+/**
+ * @brief Nmero de generadores del semigrupo i de la lista.
+ * @param L Lista.
+ * @param i ndice del semigrupo.
+ * @return Tamao de su sistema minimal.
+ */
+size_t tamanoSemigrupo(const ListaSemigrupos& L, size_t i);
+
+/**
+ * @brief Generadores del semigrupo i de la lista, sin copiarlos.
+ * @param L Lista.
+ * @param i ndice del semigrupo.
+ * @return Puntero a sus tamanoSemigrupo(L, i) generadores.
+ */
+const uint16_t* generadoresSemigrupo(const ListaSemigrupos& L, size_t i);
+
+/**
+ * @brief Cuenta las hojas de una lista.
+ * @param L Lista.
+ * @return Nmero de semigrupos marcados como hoja.
+ */
+uint64_t cuentaHojas(const ListaSemigrupos& L);
+
+/**
+ * @brief Aade al final de una lista todos los semigrupos de otra, con su clasificacin.
+ * @param destino Lista que crece.
+ * @param origen Lista que se copia.
+ */
+void concatenaListas(ListaSemigrupos& destino, const ListaSemigrupos& origen);
+
+/**
+ * @brief Ordena una lista por nmero de generadores y, a igualdad, lexicogrficamente.
+ * @param L Lista; cada semigrupo conserva su clasificacin.
  */
-bool mcdEsUno(const std::vector<int>& S);
+void ordenaLista(ListaSemigrupos& L);
 
 /**
- * @brief Genera todas las combinaciones de tamao fijo a partir de un conjunto de nmeros.
- * @param subconjuntos Contenedor donde se almacenarn las combinaciones resultantes.
- * @param combinacion Vector temporal que guarda la combinacin en construccin.
- * @param numeros Vector de entrada con los elementos de los que se extraen las combinaciones.
- * @param comienzo ndice en `numeros` desde el cual se empieza a tomar elementos.
- * @param tamano Tamao objetivo de cada combinacin.
+ * @brief Imprime, uno por lnea como <a,b,...>, los semigrupos de la lista de una clase.
+ * @param L Lista.
+ * @param hojas true para imprimir las hojas y false para los internos.
  */
-void generaCombinaciones(std::vector<std::vector<int>>& subconjuntos,
-                          std::vector<int>& combinacion,
-                          const std::vector<int>& numeros,
-                          int comienzo,
-                          int tamano);
+void imprimeLista(const ListaSemigrupos& L, bool hojas);
 
 /**
  * @brief Compara la cantidad de semigrupos numricos internos y hojas e imprime el resultado.
- * @param internos Vector de semigrupos numricos internos.
- * @param hojas   Vector de semigrupos numricos que son hojas.
+ * @param semigrupos Lista de semigrupos clasificados en internos y hojas.
+ */
+void comparaCantidades(const ListaSemigrupos& semigrupos);
+
+/**
+ * @brief Motor de bsqueda empleado para enumerar los semigrupos de un gnero fijo.
  */
-void comparaCantidades(const std::vector<std::vector<int>>& internos,
-                       const std::vector<std::vector<int>>& hojas);
+enum class MotorBusqueda {
+    ARBOL,         //Recorrido del rbol de semigrupos numricos.
+    COMBINACIONES, //Bsqueda exhaustiva sobre subconjuntos de {2,...,2gnero+1}.
+    PODA           //Bsqueda recursiva sobre los mismos subconjuntos, con poda.
+};
+
+/**
+ * @brief Construye la raz del rbol, el semigrupo N = <1>.
+ * @return Semigrupo con todos los enteros.
+ */
+SemigrupoDescomposiciones raizArbol();
+
+/**
+ * @brief Cota de los generadores minimales de cualquier semigrupo de gnero g.
+ * @param genero Gnero.
+ * @return 2g + 1.
+ */
+int cotaGeneradoresGenero(int genero);
+
+/**
+ * @brief Cota superior de los generadores minimales de un semigrupo.
+ * @param S Semigrupo.
+ * @return min(F + m, 2g + 1), o 1 para N = <1>.
+ */
+int cotaGeneradores(const SemigrupoDescomposiciones& S);
+
+/**
+ * @brief Obtiene el sistema minimal de generadores de un semigrupo.
+ * @param S Semigrupo.
+ * @return Generadores minimales ordenados de menor a mayor.
+ */
+ConjuntoGeneradores generadoresMinimales(const SemigrupoDescomposiciones& S);
+
+/**
+ * @brief Construye el hijo de un nodo al quitar uno de sus generadores minimales.
+ * @param S Nodo padre.
+ * @param x Generador minimal mayor que el Frobenius de S.
+ * @param hijo Nodo S \ {x}.
+ */
+void hijoArbol(const SemigrupoDescomposiciones& S, int x, SemigrupoDescomposiciones& hijo);
+
+/**
+ * @brief Recorre en profundidad el subrbol de S hasta el gnero buscado.
+ * @param S Nodo actual.
+ * @param genero Gnero objetivo.
+ * @param resultado Semigrupos de gnero fijo, marcando como hoja los que no tienen descendientes.
+ */
+void recorreArbol(const SemigrupoDescomposiciones& S, int genero, ListaSemigrupos& resultado);
+
+/**
+ * @brief Nmero de semigrupos internos y hoja encontrados, sin guardarlos.
+ */
+struct RecuentoSemigrupos {
+    uint64_t internos = 0;
+    uint64_t hojas = 0;
+};
+
+/**
+ * @brief Cuenta los semigrupos del gnero buscado en el subrbol de S, sin construir sus
+ *        sistemas minimales.
+ * @param S Nodo actual.
+ * @param genero Gnero objetivo.
+ * @param recuento Internos y hojas acumulados.
+ */
+void cuentaArbol(const SemigrupoDescomposiciones& S, int genero, RecuentoSemigrupos& recuento);
+
+/**
+ * @brief Profundidad de los subrboles que un hilo recorre sin dividirlos en tareas.
+ */
+const int PROFUNDIDAD_SECUENCIAL = 10;
+
+/**
+ * @brief Cola de tareas de un hilo para el reparto con robo de trabajo.
+ */
+struct ColaTrabajo {
+    std::mutex cerrojo;
+    std::deque<SemigrupoDescomposiciones> tareas;
+};
+
+/**
+ * @brief Resultados acumulados por un hilo durante el recorrido paralelo.
+ */
+struct ResultadoHilo {
+    ListaSemigrupos semigrupos;
+    RecuentoSemigrupos recuento;
+};
+
+/**
+ * @brief Obtiene una tarea de la cola propia o, si est vaca, la roba de otro hilo.
+ * @param colas Colas de todos los hilos.
+ * @param id ndice del hilo que pide trabajo.
+ * @param tarea Nodo obtenido.
+ * @return true si se ha obtenido una tarea.
+ */
+bool tomaTarea(std::vector<ColaTrabajo>& colas, int id, SemigrupoDescomposiciones& tarea);
+
+/**
+ * @brief Bucle de un hilo del recorrido paralelo del rbol.
+ * @param id ndice del hilo.
+ * @param genero Gnero objetivo.
+ * @param generoCorte Gnero a partir del cual los subrboles se recorren sin dividir.
+ * @param soloContar Si los subrboles se cuentan con cuentaArbol en lugar de guardarse.
+ * @param colas Colas de todos los hilos.
+ * @param pendientes Tareas creadas y an no terminadas.
+ * @param resultado Semigrupos (o recuento) encontrados por este hilo.
+ */
+void trabajadorArbol(int id, int genero, int generoCorte, bool soloContar, std::vector<ColaTrabajo>& colas,
+                     std::atomic<long long>& pendientes, ResultadoHilo& resultado);
+
+/**
+ * @brief Recorre el rbol con varios hilos repartiendo subrboles con robo de trabajo.
+ * @param genero Gnero objetivo.
+ * @param hilos Nmero de hilos.
+ * @param soloContar Si cada hilo solo cuenta los semigrupos en lugar de guardarlos.
+ * @param resultados Resultado de cada hilo.
+ */
+void recorreArbolParalelo(int genero, int hilos, bool soloContar, std::vector<ResultadoHilo>& resultados);
+
+/**
+ * @brief Busca los semigrupos de gnero fijo recorriendo el rbol de semigrupos numricos.
+ * @param genero Gnero fijo dado.
+ * @param hilos Nmero de hilos (1 para el recorrido secuencial).
+ * @param resultado Semigrupos numricos clasificados en internos y hojas.
+ */
+void buscaPorArbol(int genero, int hilos, ListaSemigrupos& resultado);
+
+/**
+ * @brief Cuenta los semigrupos de gnero fijo recorriendo el rbol, sin guardarlos.
+ * @param genero Gnero fijo dado.
+ * @param hilos Nmero de hilos (1 para el recorrido secuencial).
+ * @param recuento Nmero de semigrupos internos y hoja.
+ */
+void cuentaPorArbol(int genero, int hilos, RecuentoSemigrupos& recuento);
+
+/**
+ * @brief Histograma de un invariante separado en semigrupos internos y hojas.
+ */
+struct Histograma {
+    std::vector<uint64_t> internos;
+    std::vector<uint64_t> hojas;
+};
+
+/**
+ * @brief Histogramas de multiplicidad, Frobenius (desplazado en 1) y dimensin de
+ *        embebido de los semigrupos de un mismo gnero.
+ */
+struct EstadisticasGenero {
+    Histograma multiplicidad;
+    Histograma frobenius;
+    Histograma dimension;
+};
+
+/**
+ * @brief Estadsticas del recorrido del rbol hasta un gnero mximo.
+ */
+struct EstadisticasArbol {
+    int generoMaximo = 0;
+    std::vector<EstadisticasGenero> generos;
+};
+
+/**
+ * @brief Reserva los histogramas vacos de los gneros 0..generoMaximo.
+ * @param E Estadsticas a inicializar.
+ * @param generoMaximo Mayor gnero que se recorre.
+ */
+void iniciaEstadisticas(EstadisticasArbol& E, int generoMaximo);
+
+/**
+ * @brief Anota un nodo del rbol en los histogramas de su gnero.
+ * @param E Estadsticas.
+ * @param S Nodo del rbol.
+ */
+void anotaEstadisticas(EstadisticasArbol& E, const SemigrupoDescomposiciones& S);
+
+/**
+ * @brief Suma las estadsticas de un hilo a las globales.
+ * @param destino Estadsticas acumuladas.
+ * @param origen Estadsticas de un hilo.
+ */
+void sumaEstadisticas(EstadisticasArbol& destino, const EstadisticasArbol& origen);
+
+/**
+ * @brief Recorre en profundidad el subrbol de S anotando cada nodo hasta el gnero mximo.
+ * @param S Nodo actual.
+ * @param E Estadsticas del hilo que recorre el subrbol.
+ */
+void recorreEstadisticas(const SemigrupoDescomposiciones& S, EstadisticasArbol& E);
+
+/**
+ * @brief Bucle de un hilo del recorrido paralelo para estadsticas (mismo reparto que
+ *        trabajadorArbol, anotando tambin los nodos por encima del corte).
+ * @param id ndice del hilo.
+ * @param generoCorte Gnero a partir del cual los subrboles se recorren sin dividir.
+ * @param colas Colas de todos los hilos.
+ * @param pendientes Tareas creadas y an no terminadas.
+ * @param E Estadsticas propias del hilo.
+ */
+void trabajadorEstadisticas(int id, int generoCorte, std::vector<ColaTrabajo>& colas,
+                            std::atomic<long long>& pendientes, EstadisticasArbol& E);
+
+/**
+ * @brief Recorre el rbol una sola vez hasta el gnero mximo y acumula sus histogramas
+ *        en contadores por hilo, sin guardar ningn semigrupo.
+ * @param generoMaximo Mayor gnero que se recorre (a lo sumo GENERO_MAXIMO_ARBOL).
+ * @param hilos Nmero de hilos.
+ * @param E Estadsticas de todos los gneros 0..generoMaximo.
+ */
+void calculaEstadisticas(int generoMaximo, int hilos, EstadisticasArbol& E);
+
+/**
+ * @brief Formato de salida de las estadsticas.
+ */
+enum class FormatoEstadisticas {
+    CSV,
+    JSON
+};
+
+/**
+ * @brief Imprime las estadsticas en CSV (genero,invariante,valor,internos,hojas).
+ * @param E Estadsticas.
+ */
+void imprimeEstadisticasCSV(const EstadisticasArbol& E);
+
+/**
+ * @brief Imprime las estadsticas en JSON, con un objeto por gnero.
+ * @param E Estadsticas.
+ */
+void imprimeEstadisticasJSON(const EstadisticasArbol& E);
+
+/**
+ * @brief Prueba los subconjuntos de {2,...,2gnero+1} en lotes y guarda o cuenta los
+ *        semigrupos del gnero, salvo <g+1, ..., 2g+1>.
+ * @param genero Gnero fijo dado.
+ * @param resultado Lista donde se guardan los semigrupos, o nullptr para solo contarlos.
+ * @param recuento Internos y hojas acumulados cuando resultado es nullptr.
+ */
+void exploraCombinaciones(int genero, ListaSemigrupos* resultado, RecuentoSemigrupos& recuento);
+
+/**
+ * @brief Busca los semigrupos de gnero fijo probando subconjuntos de {2,...,2gnero+1}.
+ * @param genero Gnero fijo dado.
+ * @param resultado Semigrupos numricos clasificados en internos y hojas.
+ */
+void buscaPorCombinaciones(int genero, ListaSemigrupos& resultado);
+
+/**
+ * @brief Cuenta los semigrupos de gnero fijo probando subconjuntos, sin guardarlos.
+ * @param genero Gnero fijo dado.
+ * @param recuento Nmero de semigrupos internos y hoja.
+ */
+void cuentaPorCombinaciones(int genero, RecuentoSemigrupos& recuento);
+
+/**
+ * @brief Contadores del motor de bsqueda con poda.
+ */
+struct ContadoresPoda {
+    uint64_t explorados = 0; //subconjuntos parciales construidos
+    uint64_t podados = 0;    //ramas descartadas sin desarrollarlas
+};
+
+/**
+ * @brief Estado de la bsqueda recursiva con poda: conjunto alcanzable (truncado a
+ *        [0, alcance]) y nmero de huecos en [1, 2g-1] para cada profundidad.
+ */
+struct EstadoPoda {
+    int genero = 0;
+    int limite = 0;
+    int alcance = 0;
+    int tamanoMaximo = 0;
+    std::vector<std::vector<uint8_t>> pertenencia;
+    std::vector<int> huecos;
+    std::vector<int> generadores;
+    ListaSemigrupos* resultado = nullptr; //nullptr: solo se cuenta en recuento
+    RecuentoSemigrupos recuento;
+    ContadoresPoda contadores;
+};
+
+/**
+ * @brief Prepara el estado de la bsqueda con poda.
+ * @param e Estado a inicializar.
+ * @param genero Gnero objetivo.
+ * @param limite Mayor candidato a generador (cotaGeneradoresGenero).
+ * @param tamanoMaximo Nmero mximo de generadores.
+ * @param resultado Lista donde se guardan los semigrupos, o nullptr para solo contarlos.
+ */
+void iniciaPoda(EstadoPoda& e, int genero, int limite, int tamanoMaximo, ListaSemigrupos* resultado);
+
+/**
+ * @brief Aade el generador x al conjunto de la profundidad p y deja el resultado en p+1.
+ * @param e Estado de la bsqueda.
+ * @param p Profundidad actual.
+ * @param x Nuevo generador, mayor que todos los anteriores.
+ */
+void anadeGeneradorPoda(EstadoPoda& e, int p, int x);
+
+/**
+ * @brief Guarda el conjunto de la profundidad p si ya es un semigrupo del gnero pedido.
+ * @param e Estado de la bsqueda.
+ * @param p Profundidad actual.
+ * @return true si se ha guardado.
+ */
+bool registraSolucionPoda(EstadoPoda& e, int p);
+
+/**
+ * @brief Desarrolla la rama actual con generadores mayores o iguales que desde, podando
+ *        ramas con m generadores, candidatos representables, ramas con menos de g huecos en [1, 2g-1] y ramas
+ *        con ms de g huecos permanentes o alguno mayor o igual que 2g.
+ * @param e Estado de la bsqueda.
+ * @param p Profundidad actual.
+ * @param desde Menor candidato admisible.
+ */
+void exploraPoda(EstadoPoda& e, int p, int desde);
+
+/**
+ * @brief Busca los semigrupos de gnero fijo con una bsqueda recursiva con poda sobre
+ *        los mismos subconjuntos que buscaPorCombinaciones.
+ * @param genero Gnero fijo dado.
+ * @param resultado Semigrupos numricos clasificados en internos y hojas.
+ * @param contadores Nodos explorados y podados.
+ */
+void buscaPorPoda(int genero, ListaSemigrupos& resultado, ContadoresPoda& contadores);
+
+/**
+ * @brief Cuenta los semigrupos de gnero fijo con la bsqueda con poda, sin guardarlos.
+ * @param genero Gnero fijo dado.
+ * @param recuento Nmero de semigrupos internos y hoja.
+ * @param contadores Nodos explorados y podados.
+ */
+void cuentaPorPoda(int genero, RecuentoSemigrupos& recuento, ContadoresPoda& contadores);
 
 /**
  * @brief Encuentra e imprime todos los semigrupos internos y hojas para un gnero fijo.
  * @param genero Gnero fijo dado.
+ * @param motor Motor de bsqueda a emplear.
+ * @param hilos Nmero de hilos para el recorrido del rbol.
+ */
+void encontrarSemigruposYHojas(int genero, MotorBusqueda motor, int hilos);
+
+/**
+ * @brief Cuenta los semigrupos internos y hoja para un gnero fijo e imprime solo los
+ *        totales, sin construir ni imprimir las listas.
+ * @param genero Gnero fijo dado.
+ * @param motor Motor de bsqueda a emplear.
+ * @param hilos Nmero de hilos para el recorrido del rbol.
  */
-void encontrarSemigruposYHojas(int genero);
+void contarSemigruposYHojas(int genero, MotorBusqueda motor, int hilos);
 
 }
 
@@ -13,6 +13,7 @@
 
 #include <iostream>
 #include <vector>
+#include <array>
 #include <algorithm>
 #include <numeric>
 #include <unordered_map>
@@ -21,12 +22,11 @@
 #include <utility>
 #include <chrono>
 #include <regex>
+#include <cstdint>
+#include <climits>
 
 using namespace std;
 
-unordered_map<string, int> cacheGenero;
-unordered_map<string, int> cacheFrobenius;
-
 /**
  * @brief Calcula el mximo comn divisor entre dos enteros.
  * @param[in] a Primer operando.
@@ -42,362 +42,1576 @@ int maxCD(int a, int b) {
 }
 
 /**
- * @brief Genera una clave ordenada para memoizacin a partir de un vector de generadores.
- * @param[in] S Conjunto de generadores.
- * @return Cadena con los elementos de S ordenados y separados por comas.
+ * @brief Nmero de generadores que un ConjuntoGeneradores guarda sin memoria dinmica.
  */
-string clave(const vector<int>& S) {
-   vector<int> copia = S;
-   sort(copia.begin(), copia.end());
-   string k = "";
-   for (int x : copia) 
-     k += to_string(x) + ",";
-   return k;
+const int GENERADORES_EN_LINEA = 32;
+
+/**
+ * @brief Conjunto ordenado de generadores con capacidad en lnea.
+ * @details
+ *   Hasta GENERADORES_EN_LINEA generadores se guardan en un array de 16 bits dentro del
+ *   propio valor, as que crearlo o copiarlo en los bucles internos no reserva memoria;
+ *   si hay ms, todos pasan a `desbordados`. Los valores son positivos, menores que
+ *   65536, distintos y crecientes. Se construye implcitamente desde un vector<int>
+ *   (en cualquier orden; los repetidos y los no positivos se descartan), de modo que
+ *   las funciones que lo reciben siguen aceptando vectores.
+ */
+struct ConjuntoGeneradores {
+   uint16_t enLinea[GENERADORES_EN_LINEA] = {};  //Generadores, si caben.
+   vector<uint16_t> desbordados;                 //Todos los generadores, si no caben.
+   int tamano = 0;                               //Nmero de generadores.
+
+   ConjuntoGeneradores() {}
+   ConjuntoGeneradores(const vector<int>& S);
+
+   const uint16_t* begin() const { return tamano <= GENERADORES_EN_LINEA ? enLinea : desbordados.data(); }
+   const uint16_t* end() const { return begin() + tamano; }
+   size_t size() const { return tamano; }
+   bool empty() const { return tamano == 0; }
+   int operator[](size_t i) const { return begin()[i]; }
+   int front() const { return begin()[0]; }
+   int back() const { return begin()[tamano - 1]; }
+};
+
+/**
+ * @brief Aade un generador mayor que todos los del conjunto.
+ * @param[in,out] G Conjunto.
+ * @param[in] x Nuevo generador.
+ */
+void anadeGenerador(ConjuntoGeneradores& G, int x) {
+   if (G.tamano < GENERADORES_EN_LINEA) {
+      G.enLinea[G.tamano] = (uint16_t)x;
+   } else {
+      if (G.tamano == GENERADORES_EN_LINEA)
+         G.desbordados.assign(G.enLinea, G.enLinea + GENERADORES_EN_LINEA);
+      G.desbordados.push_back((uint16_t)x);
+   }
+   ++G.tamano;
 }
 
 /**
- * @brief Calcula el conductor de un semigrupo numrico.
- * @param[in] S Conjunto de generadores.
- * @return El menor n tal que todos los enteros >= n son representables.
- * @details
- *   Se expande el conjunto de alcanzables hasta encontrar un bloque de consecutivos
- *   de longitud igual al mnimo del conjunto de generadores.
- */
-int calculaConductor(const vector<int>& S) {
-   int minS = *min_element(S.begin(), S.end());
-   int maxVal = accumulate(S.begin(), S.end(), 0);
-   vector<bool> alcanzable;
-   bool encontradoBloqueConsecutivo = false;
-   int consecutivosNecesarios = minS;
-   int conductor = maxVal;
-   while (!encontradoBloqueConsecutivo) {
-      alcanzable.assign(maxVal + 1, false);
-      alcanzable[0] = true;
-
-      for (int s : S)
-         for (int i = s; i <= maxVal; ++i)
-            alcanzable[i] = alcanzable[i] || alcanzable[i - s];
-
-      int consecutivos = 0;
-      for (int i = 0; i <= maxVal; ++i) {
-         consecutivos = alcanzable[i] ? consecutivos + 1 : 0;
-         if (consecutivos >= consecutivosNecesarios) {
-            conductor = i - consecutivosNecesarios + 1;
-            encontradoBloqueConsecutivo = true;
-            break;
+ * @brief Inserta un generador en su posicin, si no estaba ya.
+ * @param[in,out] G Conjunto.
+ * @param[in] x Generador positivo.
+ */
+void insertaGenerador(ConjuntoGeneradores& G, int x) {
+   size_t posicion = lower_bound(G.begin(), G.end(), x) - G.begin();
+   if (posicion < G.size() && G[posicion] == x)
+      return;
+   anadeGenerador(G, x);
+   uint16_t* datos = G.tamano <= GENERADORES_EN_LINEA ? G.enLinea : G.desbordados.data();
+   rotate(datos + posicion, datos + G.tamano - 1, datos + G.tamano);
+}
+
+ConjuntoGeneradores::ConjuntoGeneradores(const vector<int>& S) {
+   for (int s : S)
+      if (s > 0)
+         insertaGenerador(*this, s);
+}
+
+/**
+ * @brief Invariantes bsicos de un semigrupo numrico, obtenidos en una sola pasada.
+ */
+struct InvariantesSemigrupo {
+   bool finito;            //mcd de los generadores igual a 1 (complemento finito).
+   int multiplicidad;      //Menor generador no nulo.
+   int frobenius;          //Mayor entero no representable (-1 para N).
+   int conductor;          //frobenius + 1.
+   int genero;             //Nmero de enteros no representables.
+   int dimensionEmbebido;  //Nmero de generadores minimales.
+};
+
+/**
+ * @brief Calcula los invariantes a partir del conjunto de Apry respecto a la multiplicidad.
+ * @param[in] generadores Generadores positivos, distintos, ordenados y con mcd 1.
+ * @param[out] inv Invariantes; se rellenan todos los campos salvo finito.
+ * @details
+ *   w[r] es el menor elemento del semigrupo congruente con r mdulo m. Cada generador a
+ *   se aade con una vuelta de round-robin: los restos forman mcd(a, m) ciclos r -> r+a
+ *   y cada uno se recorre desde su mnimo relajando w[r+a] = min(w[r+a], w[r]+a). Si ya
+ *   antes w[a mod m] <= a, a es suma de generadores menores y no es minimal. Al final
+ *   F = max(w) - m y el gnero es la suma de (w[r] - r)/m (frmulas de Selmer).
+ *   No hay ventana: la cota de Schur (m-1)(M-1) no cabe en int con generadores de 16
+ *   bits y la ventana ocupara varios GB, mientras que w ocupa O(m) y el coste es O(km).
+ *   Si mM llega a 2^31, F y el gnero pueden no caber en int y se saturan a INT_MAX.
+ */
+void invariantesPorApery(const ConjuntoGeneradores& generadores, InvariantesSemigrupo& inv) {
+   int m = generadores.front();
+   vector<long long> w(m, -1);
+   w[0] = 0;
+
+   inv.multiplicidad = m;
+   inv.dimensionEmbebido = 1;
+   for (size_t i = 1; i < generadores.size(); ++i) {
+      int a = generadores[i];
+      int paso = a % m;
+      if (w[paso] >= 0 && w[paso] <= a)
+         continue;
+      ++inv.dimensionEmbebido;
+      int ciclos = maxCD(m, paso);
+      int longitud = m / ciclos;
+      for (int p = 0; p < ciclos; ++p) {
+         //Se empieza por el mnimo del ciclo, que ya no puede mejorar
+         int inicio = -1, q = p;
+         for (int j = 0; j < longitud; ++j) {
+            if (w[q] >= 0 && (inicio < 0 || w[q] < w[inicio]))
+               inicio = q;
+            q = (q + paso) % m;
+         }
+         if (inicio < 0)
+            continue;
+         q = inicio;
+         for (int j = 1; j < longitud; ++j) {
+            int siguiente = (q + paso) % m;
+            if (w[siguiente] < 0 || w[q] + a < w[siguiente])
+               w[siguiente] = w[q] + a;
+            q = siguiente;
          }
       }
-      if (!encontradoBloqueConsecutivo)
-         maxVal *= 2;
    }
-   return conductor;
+
+   long long mayor = 0, genero = 0;
+   for (int r = 1; r < m; ++r) {
+      mayor = max(mayor, w[r]);
+      genero += (w[r] - r) / m;
+   }
+   long long frobenius = mayor - m;
+   inv.frobenius = (int)min<long long>(frobenius, INT_MAX);
+   inv.conductor = (int)min<long long>(frobenius + 1, INT_MAX);
+   inv.genero = (int)min<long long>(genero, INT_MAX);
 }
 
 /**
- * @brief Calcula el gnero de un semigrupo numrico.
- * @param[in] S Conjunto de generadores.
- * @return Nmero de enteros no representables por S.
+ * @brief Conjunto de enteros de [0, 64PALABRAS) guardado como bits de ancho fijo.
  * @details
- *   Utiliza algoritmo similar al del conductor para determinar hasta dnde
- *   hay un bloque de consecutivos, y cuenta cuntos valores antes de ese
- *   conductor no son alcanzables.
+ *   El ancho se fija al compilar, as que los bucles sobre las palabras se desenrollan
+ *   y el conjunto vive en la pila (o en registros) sin reservas de memoria.
  */
-int calculaGenero(const vector<int>& S) {
-   string k = clave(S);
-   if (cacheGenero.count(k))
-      return cacheGenero[k];
+template <int PALABRAS>
+struct BitsFijos {
+   array<uint64_t, PALABRAS> bloques;
+};
 
-   int minS = *min_element(S.begin(), S.end());
-   int maxVal = accumulate(S.begin(), S.end(), 0);
-   vector<bool> alcanzable;
+/**
+ * @brief Comprueba si i est en el conjunto; los enteros fuera de la ventana se dan por incluidos.
+ * @param[in] R Conjunto.
+ * @param[in] i Entero no negativo.
+ * @return true si i >= 64PALABRAS o su bit est a 1.
+ */
+template <int PALABRAS>
+inline bool contieneFijo(const BitsFijos<PALABRAS>& R, int i) {
+   if (i >= 64 * PALABRAS)
+      return true;
+   return (R.bloques[i >> 6] >> (i & 63)) & 1;
+}
 
-   bool encontradoBloqueConsecutivo = false;
-   int consecutivosNecesarios = minS;
-   int genero = 0;
-   while (!encontradoBloqueConsecutivo) {
-      alcanzable.assign(maxVal + 1, false);
-      alcanzable[0] = true;
-
-      for (int s : S)
-         for (int i = s; i <= maxVal; ++i)
-            alcanzable[i] = alcanzable[i] || alcanzable[i - s];
-
-      int consecutivos = 0;
-      for (int i = 0; i <= maxVal; ++i) {
-         consecutivos = alcanzable[i] ? consecutivos + 1 : 0;
-         if (consecutivos >= consecutivosNecesarios) {
-            encontradoBloqueConsecutivo = true;
-            break;
-         }
+/**
+ * @brief Hace R |= R << k dentro de la ventana.
+ * @param[in,out] R Conjunto.
+ * @param[in] k Desplazamiento (0 < k < 64PALABRAS).
+ */
+template <int PALABRAS>
+inline void cierraDesplazamientoFijo(BitsFijos<PALABRAS>& R, int k) {
+   int palabras = k >> 6;
+   int bits = k & 63;
+   //De la palabra ms alta a la ms baja para leer los valores previos
+   for (int i = PALABRAS - 1; i >= palabras; --i) {
+      int j = i - palabras;
+      uint64_t valor = R.bloques[j] << bits;
+      if (bits != 0 && j > 0)
+         valor |= R.bloques[j - 1] >> (64 - bits);
+      R.bloques[i] |= valor;
+   }
+}
+
+/**
+ * @brief Calcula los invariantes sobre una ventana de 64PALABRAS bits.
+ * @param[in] generadores Generadores positivos, distintos, ordenados y con mcd 1.
+ * @param[in] limite Cota de Schur max((m-1)(M-1), M) de los generadores.
+ * @param[out] inv Invariantes; se rellenan todos los campos salvo finito.
+ * @return true si el resultado es exacto.
+ * @details
+ *   Los generadores se aaden de menor a mayor y el cierre bajo
+ *   cada generador se hace por desplazamientos dobles R |= R << a, R |= R << 2a, ...
+ *   Si la ventana supera la cota de Schur el resultado es exacto; si no, solo lo es
+ *   cuando la ventana termina en un bloque de m elementos consecutivos. Los generadores
+ *   que no caben solo dejan el resultado igual si ya pertenecan, que es lo que supone
+ *   contieneFijo; si no, esa comprobacin falla.
+ */
+template <int PALABRAS>
+bool invariantesPorBitsFijos(const ConjuntoGeneradores& generadores, long long limite, InvariantesSemigrupo& inv) {
+   const int BITS = 64 * PALABRAS;
+   BitsFijos<PALABRAS> R;
+   R.bloques.fill(0);
+   R.bloques[0] = 1;
+
+   inv.multiplicidad = generadores.front();
+   inv.dimensionEmbebido = 0;
+   for (int a : generadores) {
+      if (contieneFijo(R, a))
+         continue;
+      ++inv.dimensionEmbebido;
+      for (int paso = a; paso < BITS; paso *= 2)
+         cierraDesplazamientoFijo(R, paso);
+   }
+
+   inv.frobenius = -1;
+   inv.genero = 0;
+   for (int i = 0; i < PALABRAS; ++i) {
+      uint64_t huecos = ~R.bloques[i];
+      if (huecos != 0) {
+         inv.frobenius = 64 * i + 63 - __builtin_clzll(huecos);
+         inv.genero += __builtin_popcountll(huecos);
       }
-      if (!encontradoBloqueConsecutivo)
-         maxVal *= 2;
-   }
-
-   int conductor = 0;
-   {
-      int consecutivos = 0;
-      for (int i = 0; i <= maxVal; ++i) {
-         consecutivos = alcanzable[i] ? consecutivos + 1 : 0;
-         if (consecutivos >= consecutivosNecesarios) {
-            conductor = i - consecutivosNecesarios + 1;
-            break;
+   }
+   inv.conductor = inv.frobenius + 1;
+   return limite < BITS || BITS - 1 - inv.frobenius >= inv.multiplicidad;
+}
+
+/**
+ * @brief Calcula los invariantes con la menor ventana de bits fija que contiene el conductor.
+ * @param[in] generadores Generadores positivos, distintos, ordenados y con mcd 1.
+ * @param[out] inv Invariantes; se rellenan todos los campos salvo finito.
+ * @return true si el resultado es exacto; false si hay que recurrir a invariantesPorApery.
+ * @details
+ *   Se elige entre 64, 128, 256, 512 y 1024 bits la primera ventana mayor que la cota de
+ *   Schur, de modo que los casos pequeos, que son casi todos, se resuelven con una o
+ *   dos palabras. Si la cota no cabe en 1024 bits se prueba esa ventana igualmente,
+ *   porque el conductor real suele estar muy por debajo de la cota.
+ */
+bool invariantesPorBits(const ConjuntoGeneradores& generadores, InvariantesSemigrupo& inv) {
+   long long m = generadores.front();
+   long long M = generadores.back();
+   long long limite = max((m - 1) * (M - 1), M);
+   if (limite < 64)
+      return invariantesPorBitsFijos<1>(generadores, limite, inv);
+   if (limite < 128)
+      return invariantesPorBitsFijos<2>(generadores, limite, inv);
+   if (limite < 256)
+      return invariantesPorBitsFijos<4>(generadores, limite, inv);
+   if (limite < 512)
+      return invariantesPorBitsFijos<8>(generadores, limite, inv);
+   return invariantesPorBitsFijos<16>(generadores, limite, inv);
+}
+
+/**
+ * @brief Calcula todos los invariantes bsicos de un semigrupo en una sola pasada.
+ * @param[in] generadores Conjunto de generadores (un vector se normaliza al convertirlo).
+ * @return Invariantes; si el mcd no es 1, finito = false y el resto no tiene sentido.
+ * @details
+ *   Sustituye a las programaciones dinmicas separadas de conductor, gnero, Frobenius y
+ *   minimalidad: cada semigrupo candidato se analiza una sola vez.
+ */
+InvariantesSemigrupo calculaInvariantes(const ConjuntoGeneradores& generadores) {
+   InvariantesSemigrupo inv = {false, 0, -1, 0, 0, 0};
+   if (generadores.empty())
+      return inv;
+
+   int mcd = 0;
+   for (int s : generadores)
+      mcd = maxCD(mcd, s);
+   inv.multiplicidad = generadores[0];
+   if (mcd != 1)
+      return inv;
+
+   inv.finito = true;
+   //Si el conductor cabe en una ventana de bits fija no hace falta el vector de alcanzables
+   if (invariantesPorBits(generadores, inv))
+      return inv;
+   invariantesPorApery(generadores, inv);
+   return inv;
+}
+
+/**
+ * @brief Calcula el sistema minimal sobre una ventana fija de 64PALABRAS bits.
+ * @param[in] generadores Generadores positivos, distintos y ordenados, con el mayor
+ *            menor que 64PALABRAS.
+ * @param[out] minimal Generadores que no son suma de otros, en orden creciente.
+ * @return true si [0, max(generadores)] contiene un bloque de m elementos consecutivos.
+ */
+template <int PALABRAS>
+bool sistemaMinimalFijo(const ConjuntoGeneradores& generadores, ConjuntoGeneradores& minimal) {
+   int limite = generadores.back();
+   BitsFijos<PALABRAS> R;
+   R.bloques.fill(0);
+   R.bloques[0] = 1;
+   for (int a : generadores) {
+      if (contieneFijo(R, a))
+         continue;
+      anadeGenerador(minimal, a);
+      for (int paso = a; paso <= limite; paso *= 2)
+         cierraDesplazamientoFijo(R, paso);
+   }
+
+   int m = generadores.front();
+   int consecutivos = 0;
+   for (int i = 0; i <= limite; ++i) {
+      if (contieneFijo(R, i)) {
+         if (++consecutivos >= m)
+            return true;
+      } else {
+         consecutivos = 0;
+      }
+   }
+   return false;
+}
+
+/**
+ * @brief Calcula el sistema minimal de generadores con una pasada de bits sobre [0, max(S)].
+ * @param[in] generadores Conjunto de generadores.
+ * @param[out] minimal Generadores que no son suma de otros.
+ * @return true si la ventana [0, max(S)] contiene un bloque de m elementos consecutivos
+ *         del semigrupo (m el menor generador), es decir, si ya se alcanza el conductor.
+ * @details
+ *   Los elementos se guardan en palabras de 64 bits y los generadores se recorren de
+ *   menor a mayor. Un generador cuyo bit ya est a 1 es suma de los anteriores y se
+ *   descarta; si no, se cierra la ventana bajo l con desplazamientos dobles
+ *   R |= R << a, R |= R << 2a, ... As se deciden todos los generadores en la misma
+ *   pasada, sin una expansin por cada uno. Si max(S) < 1024 se usa la menor ventana
+ *   fija (sistemaMinimalFijo) en lugar del vector.
+ */
+bool sistemaMinimal(const ConjuntoGeneradores& generadores, ConjuntoGeneradores& minimal) {
+   minimal = ConjuntoGeneradores();
+   if (generadores.empty())
+      return false;
+
+   int limite = generadores.back();
+   if (limite < 64)
+      return sistemaMinimalFijo<1>(generadores, minimal);
+   if (limite < 128)
+      return sistemaMinimalFijo<2>(generadores, minimal);
+   if (limite < 256)
+      return sistemaMinimalFijo<4>(generadores, minimal);
+   if (limite < 512)
+      return sistemaMinimalFijo<8>(generadores, minimal);
+   if (limite < 1024)
+      return sistemaMinimalFijo<16>(generadores, minimal);
+
+   int palabras = limite / 64 + 1;
+   vector<uint64_t> bits(palabras, 0);
+   bits[0] = 1;
+   for (int a : generadores) {
+      if ((bits[a >> 6] >> (a & 63)) & 1)
+         continue;
+      anadeGenerador(minimal, a);
+      for (long long paso = a; paso <= limite; paso *= 2) {
+         //R |= R << paso, de la palabra ms alta a la ms baja para leer los valores previos
+         int desplazamiento = (int)(paso >> 6);
+         int resto = (int)(paso & 63);
+         for (int i = palabras - 1; i >= desplazamiento; --i) {
+            int j = i - desplazamiento;
+            uint64_t valor = bits[j] << resto;
+            if (resto != 0 && j > 0)
+               valor |= bits[j - 1] >> (64 - resto);
+            bits[i] |= valor;
          }
       }
    }
 
-   for (int i = 0; i < conductor; ++i) {
-      if (!alcanzable[i])
-         genero++;
+   int m = generadores.front();
+   int consecutivos = 0;
+   for (int i = 0; i <= limite; ++i) {
+      if ((bits[i >> 6] >> (i & 63)) & 1) {
+         if (++consecutivos >= m)
+            return true;
+      } else {
+         consecutivos = 0;
+      }
    }
-   return cacheGenero[k] = genero;
+   return false;
 }
 
 /**
- * @brief Calcula el nmero de Frobenius de un semigrupo generado por S.
+ * @brief Comprueba si S es un sistema minimal de generadores de un semigrupo numrico.
  * @param[in] S Conjunto de generadores.
- * @return Mximo entero no representable (o -1 si todos son representables).
+ * @return true si el mcd es 1 y ningn generador es redundante.
+ * @details
+ *   La minimalidad solo depende de [0, max(S)], as que basta con sistemaMinimal; el mcd
+ *   se comprueba aparte cuando la ventana no llega al bloque de m consecutivos.
  */
-int calculaFrobenius(const vector<int>& S) {
-   string k = clave(S);
-   if (cacheFrobenius.count(k))
-      return cacheFrobenius[k];
-
-   int maxVal = accumulate(S.begin(), S.end(), 0);
-   vector<bool> alcanzable(maxVal + 1, false);
-   alcanzable[0] = true;
-
-   for (int s : S)
-      for (int i = s; i <= maxVal; ++i)
-         alcanzable[i] = alcanzable[i] || alcanzable[i - s];
+bool esMinimalHilbert(const ConjuntoGeneradores& S) {
+   if (S.size() == 1)
+      return true;
+   ConjuntoGeneradores minimal;
+   bool bloque = sistemaMinimal(S, minimal);
+   if (minimal.size() != S.size())
+      return false;
+   if (bloque)
+      return true;
+   int mcd = 0;
+   for (int s : minimal)
+      mcd = maxCD(mcd, s);
+   return mcd == 1;
+}
 
-   for (int i = maxVal; i >= 0; --i)
-      if (!alcanzable[i])
-         return cacheFrobenius[k] = i;
+/**
+ * @brief Estado de un recorrido perezoso de las combinaciones de tamao fijo.
+ * @details
+ * Sigue el orden de "puerta giratoria" (revolving door, Knuth 7.2.1.3, algoritmo R):
+ * entre dos combinaciones consecutivas slo entra un elemento y sale otro, y todas
+ * se escriben sobre el mismo bfer `combinacion`, de modo que la memoria ocupada es
+ * O(tamano) en lugar de O(C(n, tamano)).
+ */
+struct IteradorCombinaciones {
+   const vector<int>* numeros = nullptr; //elementos de los que se extraen las combinaciones
+   int tamano = 0;                       //tamao t de cada combinacin
+   vector<int> indices;                  //c[1..t] crecientes y centinela c[t+1] = n
+   vector<int> combinacion;              //combinacin actual, ordenada de menor a mayor
+   bool primera = true;                  //an no se ha visitado la primera combinacin
+   bool terminado = false;               //ya se han visitado todas las combinaciones
+};
 
-   return cacheFrobenius[k] = -1; // No existe nmero de Frobenius.
+/**
+ * @brief Prepara un iterador sobre las combinaciones de `tamano` elementos de `numeros`.
+ * @param[out] it Iterador a inicializar.
+ * @param[in] numeros Vector de entrada; debe seguir vivo mientras se use el iterador.
+ * @param[in] tamano Tamao de cada combinacin (mayor o igual que 1).
+ */
+void iniciaCombinaciones(IteradorCombinaciones& it, const vector<int>& numeros, int tamano) {
+   int n = numeros.size();
+   it.numeros = &numeros;
+   it.tamano = tamano;
+   it.indices.assign(tamano + 2, 0);
+   for (int j = 1; j <= tamano; ++j)
+      it.indices[j] = j - 1;
+   it.indices[tamano + 1] = n;
+   it.combinacion.assign(tamano, 0);
+   it.primera = true;
+   it.terminado = tamano < 1 || tamano > n;
 }
 
 /**
- * @brief Comprueba si S es minimal en forma expandida de Hilbert.
- * @param[in] S Conjunto de generadores.
- * @return true si ningn generador es redundante y se alcanza un bloque mnimo.
+ * @brief Avanza a la siguiente combinacin y la deja en `it.combinacion`.
+ * @param[in,out] it Iterador de combinaciones.
+ * @return false cuando ya no quedan combinaciones.
+ * @details
+ * Pasos R3-R5 del algoritmo R: segn la paridad de t se intenta mover c[1] y, si no
+ * es posible, se busca el primer j cuyo c[j] pueda bajar o subir una posicin. Slo
+ * se reescriben en el bfer las posiciones que han cambiado.
  */
-bool esMinimalHilbert(const vector<int>& S) {
-   if (S.size() == 1) 
+bool siguienteCombinacion(IteradorCombinaciones& it) {
+   if (it.terminado)
+      return false;
+   vector<int>& c = it.indices;
+   const vector<int>& numeros = *it.numeros;
+   int t = it.tamano;
+
+   if (it.primera) {
+      it.primera = false;
+      for (int j = 1; j <= t; ++j)
+         it.combinacion[j - 1] = numeros[c[j]];
       return true;
+   }
 
-   int minS = *min_element(S.begin(), S.end());
-   int conductor = calculaConductor(S);
-   int limit = conductor + minS;
-
-   set<int> hilbert;
-   vector<int> cola = {0};
-   hilbert.insert(0);
-
-   while (!cola.empty()) {
-      int t = cola.back(); 
-      cola.pop_back();
-      for (int a : S) {
-         int nuevoTerm = t + a;
-         if (nuevoTerm <= limit && !hilbert.count(nuevoTerm)) {
-            hilbert.insert(nuevoTerm);
-            cola.push_back(nuevoTerm);
+   int j;
+   bool incrementa;
+   if (t % 2 == 1) {
+      if (c[1] + 1 < c[2]) {
+         ++c[1];
+         it.combinacion[0] = numeros[c[1]];
+         return true;
+      }
+      j = 2;
+      incrementa = false;
+   }
+   else {
+      if (c[1] > 0) {
+         --c[1];
+         it.combinacion[0] = numeros[c[1]];
+         return true;
+      }
+      j = 2;
+      incrementa = true;
+   }
+
+   while (j <= t) {
+      if (!incrementa) {
+         //R4: aqu c[j] = c[j-1] + 1, se intenta bajar c[j]
+         if (c[j] >= j) {
+            c[j] = c[j - 1];
+            c[j - 1] = j - 2;
+            it.combinacion[j - 1] = numeros[c[j]];
+            it.combinacion[j - 2] = numeros[c[j - 1]];
+            return true;
+         }
+         ++j;
+      }
+      else {
+         //R5: aqu c[j-1] = j - 2, se intenta subir c[j]
+         if (c[j] + 1 < c[j + 1]) {
+            c[j - 1] = c[j];
+            ++c[j];
+            it.combinacion[j - 1] = numeros[c[j]];
+            it.combinacion[j - 2] = numeros[c[j - 1]];
+            return true;
          }
+         ++j;
       }
+      incrementa = !incrementa;
    }
+   it.terminado = true;
+   return false;
+}
 
-   int consecutivos = 0;
-   int prev = -2; //el primero no se debe contar como consecutivo.
-   for (int n : hilbert) {
-      consecutivos = (n == prev + 1) ? consecutivos + 1 : 1;
-      if (consecutivos >= minS) 
-         break;
-      prev = n;
+/**
+ * @brief Nmero mximo de candidatos que se evalan juntos en un lote.
+ */
+const int TAMANO_LOTE = 256;
+
+/**
+ * @brief Bloque de candidatos guardado como estructura de arrays.
+ * @details
+ *   generadores[j][c] es el j-simo generador (en orden creciente) del candidato c, de
+ *   modo que el paso j de todos los candidatos lee una fila contigua. Cada candidato
+ *   tiene entre 1 y GENERADORES_EN_LINEA generadores.
+ */
+struct LoteCandidatos {
+   int cantidad = 0;                                        //Candidatos en el lote.
+   uint8_t tamanos[TAMANO_LOTE];                            //Generadores de cada candidato.
+   uint16_t generadores[GENERADORES_EN_LINEA][TAMANO_LOTE]; //Generadores por posicin.
+};
+
+/**
+ * @brief Resultados de evaluaLote, uno por candidato.
+ */
+struct ResultadosLote {
+   uint8_t mcdUno[TAMANO_LOTE];   //1 si el mcd de los generadores es 1.
+   uint8_t minimal[TAMANO_LOTE];  //1 si el mcd es 1 y ningn generador es suma de los dems.
+   uint8_t hoja[TAMANO_LOTE];     //1 si el mcd es 1 y el Frobenius supera al mayor generador.
+   int genero[TAMANO_LOTE];       //Nmero de huecos, o -1 si el mcd no es 1.
+   int frobenius[TAMANO_LOTE];    //Mayor hueco (-1 para N), o -1 si el mcd no es 1.
+};
+
+/**
+ * @brief Aade un candidato al final de un lote.
+ * @param[in,out] lote Lote con sitio libre.
+ * @param[in] S Conjunto de 1 a GENERADORES_EN_LINEA generadores.
+ */
+void anadeCandidatoLote(LoteCandidatos& lote, const ConjuntoGeneradores& S) {
+   int c = lote.cantidad++;
+   lote.tamanos[c] = (uint8_t)S.size();
+   for (size_t j = 0; j < S.size(); ++j)
+      lote.generadores[j][c] = (uint16_t)S[j];
+}
+
+/**
+ * @brief Reconstruye el conjunto de generadores de un candidato del lote.
+ * @param[in] lote Lote.
+ * @param[in] c ndice del candidato.
+ * @return Sus generadores.
+ */
+ConjuntoGeneradores candidatoDeLote(const LoteCandidatos& lote, int c) {
+   ConjuntoGeneradores S;
+   for (int j = 0; j < lote.tamanos[c]; ++j)
+      anadeGenerador(S, lote.generadores[j][c]);
+   return S;
+}
+
+/**
+ * @brief Evala parte de un lote sobre una ventana comn de 64PALABRAS bits.
+ * @param[in] lote Lote.
+ * @param[in] indices Candidatos del lote que se evalan.
+ * @param[in] n Nmero de ndices.
+ * @param[out] r Resultados de los candidatos exactos.
+ * @param[out] exacto exacto[c] = 1 si el resultado de c es vlido; si no, hay que
+ *             recalcularlo con las funciones de un solo conjunto.
+ * @details
+ *   Es invariantesPorBitsFijos con los candidatos en paralelo: sus conjuntos R se
+ *   guardan como estructura de arrays y en el paso j cada candidato decide y cierra su
+ *   j-simo generador, as que el cierre, el mcd y el recuento final recorren filas
+ *   contiguas. La exactitud se decide por candidato con la misma regla.
+ */
+template <int PALABRAS>
+void evaluaLoteFijo(const LoteCandidatos& lote, const int* indices, int n, ResultadosLote& r, uint8_t* exacto) {
+   const int BITS = 64 * PALABRAS;
+   uint64_t R[PALABRAS][TAMANO_LOTE];
+   int mcd[TAMANO_LOTE];
+   int dimension[TAMANO_LOTE];
+   int pasos = 0;
+   for (int t = 0; t < n; ++t) {
+      R[0][t] = 1;
+      for (int i = 1; i < PALABRAS; ++i)
+         R[i][t] = 0;
+      mcd[t] = 0;
+      dimension[t] = 0;
+      pasos = max(pasos, (int)lote.tamanos[indices[t]]);
    }
-   if (consecutivos < minS) 
-      return false;
 
-   //Se comprueba que ningn elemento de S puede generarse sin l mismo.
-   for (size_t i = 0; i < S.size(); ++i) {
-      vector<int> copia = S;
-      copia.erase(copia.begin() + i);
-      set<int> formaExpandida;
-      vector<int> cola = {0};
-      formaExpandida.insert(0);
-      int lim = S[i] + 1;
-      while (!cola.empty()) {
-         int t = cola.back(); 
-         cola.pop_back();
-         for (int a : copia) {
-            int nuevo = t + a;
-            if (nuevo <= lim && !formaExpandida.count(nuevo)) {
-               formaExpandida.insert(nuevo);
-               cola.push_back(nuevo);
+   for (int j = 0; j < pasos; ++j) {
+      const uint16_t* fila = lote.generadores[j];
+      for (int t = 0; t < n; ++t) {
+         int c = indices[t];
+         if (j >= lote.tamanos[c])
+            continue;
+         int a = fila[c];
+         mcd[t] = maxCD(mcd[t], a);
+         //Fuera de la ventana se da por incluido, como en contieneFijo
+         if (a >= BITS || ((R[a >> 6][t] >> (a & 63)) & 1))
+            continue;
+         ++dimension[t];
+         for (int paso = a; paso < BITS; paso *= 2) {
+            int palabras = paso >> 6;
+            int bits = paso & 63;
+            for (int i = PALABRAS - 1; i >= palabras; --i) {
+               int k = i - palabras;
+               uint64_t valor = R[k][t] << bits;
+               if (bits != 0 && k > 0)
+                  valor |= R[k - 1][t] >> (64 - bits);
+               R[i][t] |= valor;
             }
          }
       }
-      if (formaExpandida.count(S[i]))
-         return false; //El elemento puede generarse sin el mismo.
    }
 
-   //Se comprueba que todos los elementos generadores estn en la forma expandida.
-   for (int s : S) {
-      if (!hilbert.count(s))
-         return false;
+   for (int t = 0; t < n; ++t) {
+      int c = indices[t];
+      int tamano = lote.tamanos[c];
+      int m = lote.generadores[0][c];
+      int M = lote.generadores[tamano - 1][c];
+      int frobenius = -1, genero = 0;
+      for (int i = 0; i < PALABRAS; ++i) {
+         uint64_t huecos = ~R[i][t];
+         if (huecos != 0) {
+            frobenius = 64 * i + 63 - __builtin_clzll(huecos);
+            genero += __builtin_popcountll(huecos);
+         }
+      }
+      long long limite = max((long long)(m - 1) * (M - 1), (long long)M);
+      r.mcdUno[c] = mcd[t] == 1;
+      if (r.mcdUno[c]) {
+         exacto[c] = limite < BITS || BITS - 1 - frobenius >= m;
+         r.minimal[c] = dimension[t] == tamano;
+         r.genero[c] = genero;
+         r.frobenius[c] = frobenius;
+         r.hoja[c] = frobenius > M;
+      } else {
+         //Sin mcd 1 no hay semigrupo numrico, as que tampoco se marca como minimal
+         exacto[c] = 1;
+         r.minimal[c] = 0;
+         r.genero[c] = -1;
+         r.frobenius[c] = -1;
+         r.hoja[c] = 0;
+      }
+   }
+}
+
+/**
+ * @brief Calcula mcd, gnero, Frobenius, minimalidad y hoja de todos los candidatos de un lote.
+ * @param[in] lote Lote de candidatos.
+ * @param[out] r Resultados de cada candidato (ver ResultadosLote).
+ * @details
+ *   Los candidatos se reparten por la menor ventana de 64, 128, 256, 512 o 1024 bits que
+ *   supera su cota de Schur (como en invariantesPorBits) y cada grupo se evala a la vez
+ *   con evaluaLoteFijo, de modo que un candidato con cota grande no obliga a todo el lote
+ *   a usar la ventana ancha. Los candidatos cuyo resultado no es exacto en su ventana
+ *   se recalculan uno a uno.
+ */
+void evaluaLote(const LoteCandidatos& lote, ResultadosLote& r) {
+   int indices[5][TAMANO_LOTE];
+   int cuantos[5] = {0, 0, 0, 0, 0};
+   for (int c = 0; c < lote.cantidad; ++c) {
+      long long m = lote.generadores[0][c];
+      long long M = lote.generadores[lote.tamanos[c] - 1][c];
+      long long limite = max((m - 1) * (M - 1), M);
+      int grupo = limite < 64 ? 0 : limite < 128 ? 1 : limite < 256 ? 2 : limite < 512 ? 3 : 4;
+      indices[grupo][cuantos[grupo]++] = c;
    }
+   uint8_t exacto[TAMANO_LOTE];
+   evaluaLoteFijo<1>(lote, indices[0], cuantos[0], r, exacto);
+   evaluaLoteFijo<2>(lote, indices[1], cuantos[1], r, exacto);
+   evaluaLoteFijo<4>(lote, indices[2], cuantos[2], r, exacto);
+   evaluaLoteFijo<8>(lote, indices[3], cuantos[3], r, exacto);
+   evaluaLoteFijo<16>(lote, indices[4], cuantos[4], r, exacto);
 
-   return true;
+   for (int c = 0; c < lote.cantidad; ++c) {
+      if (exacto[c])
+         continue;
+      ConjuntoGeneradores S = candidatoDeLote(lote, c);
+      InvariantesSemigrupo inv = calculaInvariantes(S);
+      r.mcdUno[c] = inv.finito;
+      r.minimal[c] = inv.finito && esMinimalHilbert(S);
+      r.genero[c] = inv.finito ? inv.genero : -1;
+      r.frobenius[c] = inv.finito ? inv.frobenius : -1;
+      r.hoja[c] = inv.finito && inv.frobenius > S.back();
+   }
 }
 
 /**
- * @brief Determina si S genera un semigrupo hoja (F > max(S)).
- * @param[in] S Conjunto de generadores.
- * @param[in] genero Entero que indica el gnero.
- * @return true si S genera el gnero dado y su Frobenius supera al mximo generador.
+ * @brief Lista compacta de semigrupos en formato CSR (filas comprimidas).
+ * @details
+ *   Los generadores de todos los semigrupos van seguidos en un nico array de 16 bits y
+ *   el semigrupo i ocupa valores[inicios[i]..inicios[i+1]). La clasificacin en hoja o
+ *   interno se guarda en un mapa de bits aparte. Frente a vector<vector<int>> se evita
+ *   una reserva de memoria y 24 bytes de cabecera por semigrupo, y cada valor ocupa la
+ *   mitad. Los generadores deben ser menores que 65536 y el total de valores menor
+ *   que 2^32.
  */
-bool esHoja(const vector<int>& S, int genero) {
-   if (calculaGenero(S) != genero)
-      return false;
-   int f = calculaFrobenius(S);
-   if (f == -1)
-      return false;
-   int max_elem = *max_element(S.begin(), S.end());
-   return f > max_elem;
+struct ListaSemigrupos {
+   vector<uint16_t> valores;                         //Generadores de todos los semigrupos, seguidos.
+   vector<uint32_t> inicios = vector<uint32_t>(1, 0); //Inicio de cada semigrupo y final del ltimo.
+   vector<uint64_t> hojas;                           //Bit i a 1 si el semigrupo i es hoja.
+};
+
+/**
+ * @brief Nmero de semigrupos de una lista.
+ * @param[in] L Lista.
+ * @return Nmero de semigrupos guardados.
+ */
+size_t numSemigrupos(const ListaSemigrupos& L) {
+   return L.inicios.size() - 1;
 }
 
 /**
- * @brief Genera recursivamente todas las combinaciones de tamao tamano.
- * @param[out] subconjuntos Acumula las combinaciones generadas.
- * @param[in,out] combinacion Vector auxiliar para la combinacin actual.
- * @param[in] numeros Conjunto de nmeros candidatos.
- * @param[in] comienzo ndice desde el que aadir en esta llamada.
- * @param[in] tamano Longitud deseada de cada combinacin.
+ * @brief Aade un semigrupo al final de una lista.
+ * @param[in,out] L Lista.
+ * @param[in] generadores Generadores minimales, en el orden en que se guardarn.
+ * @param[in] tamano Nmero de generadores.
+ * @param[in] hoja Si el semigrupo es hoja.
  */
-void generaCombinaciones(vector<vector<int>>& subconjuntos, vector<int>& combinacion, const vector<int>& numeros, int comienzo, int tamano) {
-   if (combinacion.size() == tamano) {
-      subconjuntos.push_back(combinacion);
-      return;
-   }
-   for (int i = comienzo; i < numeros.size(); ++i) {
-      combinacion.push_back(numeros[i]);
-      generaCombinaciones(subconjuntos, combinacion, numeros, i + 1, tamano);
-      combinacion.pop_back();
+void anadeSemigrupo(ListaSemigrupos& L, const uint16_t* generadores, size_t tamano, bool hoja) {
+   size_t i = numSemigrupos(L);
+   if (i % 64 == 0)
+      L.hojas.push_back(0);
+   if (hoja)
+      L.hojas[i / 64] |= 1ULL << (i % 64);
+   L.valores.insert(L.valores.end(), generadores, generadores + tamano);
+   L.inicios.push_back((uint32_t)L.valores.size());
+}
+
+/**
+ * @brief Aade un semigrupo al final de una lista.
+ * @param[in,out] L Lista.
+ * @param[in] S Generadores minimales.
+ * @param[in] hoja Si el semigrupo es hoja.
+ */
+void anadeSemigrupo(ListaSemigrupos& L, const ConjuntoGeneradores& S, bool hoja) {
+   anadeSemigrupo(L, S.begin(), S.size(), hoja);
+}
+
+/**
+ * @brief Indica si el semigrupo i de la lista es hoja.
+ * @param[in] L Lista.
+ * @param[in] i ndice del semigrupo.
+ * @return true si es hoja.
+ */
+bool esHojaLista(const ListaSemigrupos& L, size_t i) {
+   return (L.hojas[i / 64] >> (i % 64)) & 1;
+}
+
+/**
+ * @brief Nmero de generadores del semigrupo i de la lista.
+ * @param[in] L Lista.
+ * @param[in] i ndice del semigrupo.
+ * @return Tamao de su sistema minimal.
+ */
+size_t tamanoSemigrupo(const ListaSemigrupos& L, size_t i) {
+   return L.inicios[i + 1] - L.inicios[i];
+}
+
+/**
+ * @brief Generadores del semigrupo i de la lista, sin copiarlos.
+ * @param[in] L Lista.
+ * @param[in] i ndice del semigrupo.
+ * @return Puntero a sus tamanoSemigrupo(L, i) generadores.
+ */
+const uint16_t* generadoresSemigrupo(const ListaSemigrupos& L, size_t i) {
+   return L.valores.data() + L.inicios[i];
+}
+
+/**
+ * @brief Cuenta las hojas de una lista.
+ * @param[in] L Lista.
+ * @return Nmero de semigrupos marcados como hoja.
+ */
+uint64_t cuentaHojas(const ListaSemigrupos& L) {
+   uint64_t total = 0;
+   for (uint64_t palabra : L.hojas)
+      total += __builtin_popcountll(palabra);
+   return total;
+}
+
+/**
+ * @brief Ordena una lista por nmero de generadores y, a igualdad, lexicogrficamente.
+ * @param[in,out] L Lista; cada semigrupo conserva su clasificacin.
+ * @details
+ *   Se ordena una permutacin de ndices comparando directamente los tramos del array
+ *   de valores y despus se reconstruye la lista en ese orden.
+ */
+void ordenaLista(ListaSemigrupos& L) {
+   size_t n = numSemigrupos(L);
+   vector<uint32_t> orden(n);
+   for (size_t i = 0; i < n; ++i)
+      orden[i] = (uint32_t)i;
+   sort(orden.begin(), orden.end(), [&L](uint32_t a, uint32_t b) {
+      size_t ta = tamanoSemigrupo(L, a), tb = tamanoSemigrupo(L, b);
+      if (ta != tb)
+         return ta < tb;
+      const uint16_t* ga = generadoresSemigrupo(L, a);
+      return lexicographical_compare(ga, ga + ta, generadoresSemigrupo(L, b), generadoresSemigrupo(L, b) + tb);
+   });
+
+   ListaSemigrupos ordenada;
+   ordenada.valores.reserve(L.valores.size());
+   ordenada.inicios.reserve(L.inicios.size());
+   ordenada.hojas.assign(L.hojas.size(), 0);
+   for (size_t k = 0; k < n; ++k) {
+      const uint16_t* g = generadoresSemigrupo(L, orden[k]);
+      if (esHojaLista(L, orden[k]))
+         ordenada.hojas[k / 64] |= 1ULL << (k % 64);
+      ordenada.valores.insert(ordenada.valores.end(), g, g + tamanoSemigrupo(L, orden[k]));
+      ordenada.inicios.push_back((uint32_t)ordenada.valores.size());
    }
+   L.valores.swap(ordenada.valores);
+   L.inicios.swap(ordenada.inicios);
+   L.hojas.swap(ordenada.hojas);
 }
 
 /**
- * @brief Comprueba si los elementos de S son globalmente coprimos.
- * @param[in] S Conjunto de generadores.
- * @return true si el mcd acumulado termina en 1.
- */
-bool mcdEsUno(const vector<int>& S) {
-   if (S.empty()) return false;
-   int mcd = S[0];
-   for (size_t i = 1; i < S.size(); ++i) {
-      mcd = maxCD(mcd, S[i]);
-      if (mcd == 1) 
-         return true;
+ * @brief Imprime, uno por lnea como <a,b,...>, los semigrupos de la lista de una clase.
+ * @param[in] L Lista.
+ * @param[in] hojas true para imprimir las hojas y false para los internos.
+ */
+void imprimeLista(const ListaSemigrupos& L, bool hojas) {
+   for (size_t i = 0; i < numSemigrupos(L); ++i) {
+      if (esHojaLista(L, i) != hojas)
+         continue;
+      const uint16_t* g = generadoresSemigrupo(L, i);
+      size_t n = tamanoSemigrupo(L, i);
+      cout << "<";
+      for (size_t j = 0; j < n; ++j)
+         cout << g[j] << (j + 1 < n ? "," : "");
+      cout << ">\n";
    }
-   return mcd == 1;
 }
 
 /**
- * @brief Compara y muestra cul de dos conjuntos tiene ms semigrupos.
- * @param[in] internos Lista de semigrupos numricos internos.
- * @param[in] hojas    Lista de semigrupos numricos hoja.
+ * @brief Compara y muestra cul de las dos clases tiene ms semigrupos.
+ * @param[in] semigrupos Lista de semigrupos clasificados en internos y hojas.
  */
-void comparaCantidades(const vector<vector<int>>& internos, const vector<vector<int>>& hojas) {
+void comparaCantidades(const ListaSemigrupos& semigrupos) {
+   uint64_t hojas = cuentaHojas(semigrupos);
+   uint64_t internos = numSemigrupos(semigrupos) - hojas;
    cout << "\nComparacion:\n";
-   if (internos.size() > hojas.size())
+   if (internos > hojas)
       cout << "Hay mas semigrupos numericos internos que hojas.\n";
-   else if (internos.size() < hojas.size())
+   else if (internos < hojas)
       cout << "Hay mas semigrupos numericos hojas que internos.\n";
    else
       cout << "Hay igual cantidad de semigrupos numericos internos y hojas.\n";
 }
 
 /**
- * @brief Busca y clasifica semigrupos numricos de gnero y multiplicidad fijos.
+ * @brief Motor de bsqueda empleado para enumerar los semigrupos de gnero y multiplicidad fijos.
+ */
+enum class MotorBusqueda {
+   KUNZ,          //Puntos enteros del poliedro de Kunz.
+   PODA,          //Bsqueda recursiva con poda.
+   COMBINACIONES  //Bsqueda exhaustiva sobre subconjuntos de {m,...,2gnero+1}.
+};
+
+/**
+ * @brief Cota de los generadores minimales de cualquier semigrupo de gnero g.
+ * @param[in] genero Gnero.
+ * @return 2g + 1.
+ * @details
+ *   Si x es generador minimal y s pertenece a S con 0 < s < x, x - s es un hueco (si no,
+ *   x = s + (x - s)); as, al menos la mitad de [1, x-1] son huecos y x - 1 <= 2g. Se
+ *   alcanza en <2, 2g+1> y en <g+1, ..., 2g+1>.
+ */
+int cotaGeneradoresGenero(int genero) {
+   return 2 * genero + 1;
+}
+
+/**
+ * @brief Nmero de semigrupos internos y hoja encontrados, sin guardarlos.
+ */
+struct RecuentoSemigrupos {
+   uint64_t internos = 0;
+   uint64_t hojas = 0;
+};
+
+/**
+ * @brief Prueba los subconjuntos con la multiplicidad dada y guarda o cuenta los semigrupos del gnero.
  * @param[in] genero        Gnero objetivo.
  * @param[in] multiplicidad Mnimo elemento (multiplicidad) de cada semigrupo sin contar el 0.
+ * @param[out] resultado    Lista donde se guardan los semigrupos, o nullptr para solo contarlos.
+ * @param[in,out] recuento  Internos y hojas acumulados cuando resultado es nullptr.
  * @details
- *   - Genera todas las combinaciones de tamao 2..gnero de los nmeros
- *     desde multiplicidad hasta 5gnero.
- *   - Filtra por mcdEsUno, clculo exacto de gnero y minimalidad de Hilbert.
- *   - Si cumple esHoja, entonces hoja; si no, interno.
- *   - Si multiplicidad == gnero+1, aade el semigrupo <F+1,,2F+1>.
- *   - Imprime ambos conjuntos y compara sus tamaos.
+ *   - Genera los conjuntos {m} unin C, con C de a lo sumo m-1 nmeros de
+ *     {m+1,...,2gnero+1}: un sistema minimal tiene como mucho un generador por
+ *     clase de resto mdulo m y ninguno supera cotaGeneradoresGenero.
+ *   - Filtra por mcd 1, gnero exacto y minimalidad de Hilbert, en lotes de
+ *     TAMANO_LOTE candidatos evaluados a la vez (evaluaLote).
+ *   - Si el Frobenius supera al mayor generador, hoja; si no, interno.
+ *   - Con multiplicidad == gnero+1 no prueba nada: el nico semigrupo es <F+1,,2F+1>.
  */
-void encontrarSemigruposYHojas(int genero, int multiplicidad) {
-   vector<vector<int>> internos;
-   vector<vector<int>> hojas;
-
-   //se limita el espacio de bsqueda con lmite
-   int limite = genero * 5;
+void exploraCombinaciones(int genero, int multiplicidad, ListaSemigrupos* resultado, RecuentoSemigrupos& recuento) {
+   int limite = cotaGeneradoresGenero(genero);
    vector<int> numeros;
-   for (int i = multiplicidad; i <= limite; ++i)
+   for (int i = multiplicidad + 1; i <= limite; ++i)
       numeros.push_back(i);
+   int restoMaximo = multiplicidad <= genero ? multiplicidad - 1 : 0;
 
-   for (int tamano = 2; tamano <= genero; ++tamano) {
-      vector<vector<int>> subconjuntos;
-      vector<int> combinacion;
-      generaCombinaciones(subconjuntos, combinacion, numeros, 0, tamano);
+   IteradorCombinaciones it;
+   LoteCandidatos lote;
+   ResultadosLote r;
+   for (int resto = 1; resto <= restoMaximo; ++resto) {
+      iniciaCombinaciones(it, numeros, resto);
+      bool quedan = true;
+      while (quedan) {
+         //Se juntan hasta TAMANO_LOTE candidatos y se analizan todos a la vez
+         lote.cantidad = 0;
+         while (lote.cantidad < TAMANO_LOTE && (quedan = siguienteCombinacion(it))) {
+            //la multiplicidad es siempre el menor generador
+            ConjuntoGeneradores candidato;
+            anadeGenerador(candidato, multiplicidad);
+            for (int x : it.combinacion)
+               anadeGenerador(candidato, x);
+            anadeCandidatoLote(lote, candidato);
+         }
+         evaluaLote(lote, r);
+         for (int c = 0; c < lote.cantidad; ++c) {
+            if (!r.mcdUno[c] || r.genero[c] != genero || !r.minimal[c])
+               continue;
+            //Se clasifica en semigrupos numricos internos u hojas
+            if (resultado == nullptr)
+               ++(r.hoja[c] ? recuento.hojas : recuento.internos);
+            else
+               anadeSemigrupo(*resultado, candidatoDeLote(lote, c), r.hoja[c]);
+         }
+      }
+   }
+}
 
-      for (const auto& subconjunto : subconjuntos) {
-         //se debe incluir la multiplicidad como mnimo
-         if (*min_element(subconjunto.begin(), subconjunto.end()) != multiplicidad)
-            continue;
-         if (!mcdEsUno(subconjunto))
-            continue;
-         if (calculaGenero(subconjunto) != genero)
-            continue;
-         if (!esMinimalHilbert(subconjunto))
-            continue;
+/**
+ * @brief Busca semigrupos de gnero y multiplicidad fijos probando subconjuntos.
+ * @param[in] genero        Gnero objetivo.
+ * @param[in] multiplicidad Mnimo elemento (multiplicidad) de cada semigrupo sin contar el 0.
+ * @param[out] resultado Semigrupos numricos clasificados en internos y hojas.
+ * @details
+ *   Los candidatos salen de exploraCombinaciones. Si multiplicidad == gnero+1, aade
+ *   el semigrupo <F+1,,2F+1>, el nico con esa multiplicidad.
+ */
+void buscaPorCombinaciones(int genero, int multiplicidad, ListaSemigrupos& resultado) {
+   RecuentoSemigrupos sinUso;
+   exploraCombinaciones(genero, multiplicidad, &resultado, sinUso);
+
+   if(multiplicidad == genero + 1){
+      vector<int> semigrupoExtra;
+      for (int i = genero + 1; i <= 2 * genero + 1; ++i)
+         semigrupoExtra.push_back(i);
+      anadeSemigrupo(resultado, semigrupoExtra, false);
+   }
 
-         //Se clasifica en semigrupos numricos internos u hojas
-         if (esHoja(subconjunto, genero))
-            hojas.push_back(subconjunto);
-         else
-            internos.push_back(subconjunto);
+   //el iterador sigue el orden de puerta giratoria, no el lexicogrfico
+   ordenaLista(resultado);
+}
+
+/**
+ * @brief Cuenta los semigrupos de gnero y multiplicidad fijos probando subconjuntos, sin guardarlos.
+ * @param[in] genero        Gnero objetivo.
+ * @param[in] multiplicidad Mnimo elemento (multiplicidad) de cada semigrupo sin contar el 0.
+ * @param[out] recuento     Nmero de semigrupos internos y hoja.
+ */
+void cuentaPorCombinaciones(int genero, int multiplicidad, RecuentoSemigrupos& recuento) {
+   recuento = RecuentoSemigrupos();
+   exploraCombinaciones(genero, multiplicidad, nullptr, recuento);
+   if (multiplicidad == genero + 1)
+      ++recuento.internos;
+}
+
+/**
+ * @brief Contadores del motor de bsqueda con poda.
+ */
+struct ContadoresPoda {
+   uint64_t explorados = 0; //subconjuntos parciales construidos
+   uint64_t podados = 0;    //ramas descartadas sin desarrollarlas
+};
+
+/**
+ * @brief Estado de la bsqueda recursiva con poda.
+ * @details
+ *   pertenencia[p] es el semigrupo generado por los p primeros generadores elegidos,
+ *   truncado a [0, alcance]; como los generadores se aaden en orden creciente, cada
+ *   nivel se obtiene del anterior en O(alcance) y deshacer un paso es volver al nivel p.
+ *   Los candidatos llegan hasta limite, pero registraSolucionPoda necesita ver
+ *   [2g, 2g+m-1], y m <= g+1.
+ */
+struct EstadoPoda {
+   int genero = 0;
+   int limite = 0;                       //mayor candidato de la ventana
+   int alcance = 0;                      //mayor entero representado en pertenencia
+   int tamanoMaximo = 0;                 //nmero mximo de generadores
+   vector<vector<uint8_t>> pertenencia;  //conjunto alcanzable en cada profundidad
+   vector<int> huecos;                   //huecos en [1, 2g-1] en cada profundidad
+   vector<int> generadores;              //generadores elegidos hasta ahora
+   ListaSemigrupos* resultado = nullptr; //nullptr: solo se cuenta en recuento
+   RecuentoSemigrupos recuento;
+   ContadoresPoda contadores;
+};
+
+/**
+ * @brief Prepara el estado de la bsqueda con poda.
+ * @param[out] e Estado a inicializar.
+ * @param[in] genero Gnero objetivo.
+ * @param[in] limite Mayor candidato a generador.
+ * @param[in] tamanoMaximo Nmero mximo de generadores.
+ * @param[out] resultado Lista donde se guardan los semigrupos, o nullptr para solo contarlos.
+ */
+void iniciaPoda(EstadoPoda& e, int genero, int limite, int tamanoMaximo, ListaSemigrupos* resultado) {
+   e.genero = genero;
+   e.limite = limite;
+   e.alcance = max(limite, 3 * genero);
+   e.tamanoMaximo = tamanoMaximo;
+   e.pertenencia.assign(tamanoMaximo + 1, vector<uint8_t>(e.alcance + 1, 0));
+   e.pertenencia[0][0] = 1;
+   e.huecos.assign(tamanoMaximo + 1, 0);
+   e.huecos[0] = max(2 * genero - 1, 0);
+   e.generadores.clear();
+   e.resultado = resultado;
+   e.recuento = RecuentoSemigrupos();
+   e.contadores = ContadoresPoda();
+}
+
+/**
+ * @brief Aade el generador x al conjunto de la profundidad p y deja el resultado en p+1.
+ * @param[in,out] e Estado de la bsqueda.
+ * @param[in] p Profundidad actual.
+ * @param[in] x Nuevo generador, mayor que todos los anteriores.
+ * @details
+ *   Recorriendo i en orden creciente, i pertenece si ya perteneca o si i-x pertenece
+ *   (incluidos los que se acaban de aadir), lo que da todos los s + kx.
+ */
+void anadeGeneradorPoda(EstadoPoda& e, int p, int x) {
+   vector<uint8_t>& siguiente = e.pertenencia[p + 1];
+   siguiente = e.pertenencia[p];
+   int cota = 2 * e.genero - 1;
+   int nuevos = 0;
+   for (int i = x; i <= e.alcance; ++i) {
+      if (!siguiente[i] && siguiente[i - x]) {
+         siguiente[i] = 1;
+         if (i <= cota)
+            ++nuevos;
       }
    }
-    
+   e.huecos[p + 1] = e.huecos[p] - nuevos;
+   e.generadores.push_back(x);
+}
+
+/**
+ * @brief Clasifica el conjunto de la profundidad p si ya es un semigrupo del gnero pedido.
+ * @param[in,out] e Estado de la bsqueda.
+ * @param[in] p Profundidad actual.
+ * @return true si es un semigrupo de gnero g (y se ha guardado o contado), false en otro caso.
+ * @details
+ *   Si [2g, 2g+m-1] est en el conjunto, todo entero mayor tambin lo est, as que no
+ *   hay huecos fuera de [1, 2g-1] y el gnero es el nmero de huecos contado; esto ya
+ *   implica que el mcd es 1.
+ */
+bool registraSolucionPoda(EstadoPoda& e, int p) {
+   const vector<uint8_t>& actual = e.pertenencia[p];
+   int m = e.generadores[0];
+   int desde = 2 * e.genero;
+   if (e.huecos[p] != e.genero || desde + m - 1 > e.alcance)
+      return false;
+   for (int i = desde; i < desde + m; ++i)
+      if (!actual[i])
+         return false;
+
+   int frobenius = desde - 1;
+   while (frobenius > 0 && actual[frobenius])
+      --frobenius;
+   bool hoja = e.generadores.back() < frobenius;
+   if (e.resultado == nullptr)
+      ++(hoja ? e.recuento.hojas : e.recuento.internos);
+   else
+      anadeSemigrupo(*e.resultado, e.generadores, hoja);
+   return true;
+}
+
+/**
+ * @brief Desarrolla la rama actual aadiendo generadores mayores o iguales que desde.
+ * @param[in,out] e Estado de la bsqueda.
+ * @param[in] p Profundidad actual (nmero de generadores elegidos).
+ * @param[in] desde Menor candidato admisible.
+ * @details
+ *   Se poda:
+ *     - una rama que ya tiene m generadores, pues un sistema minimal no tiene dos
+ *       generadores en la misma clase de resto mdulo m;
+ *     - un candidato que ya pertenece al conjunto, pues sera representable por los
+ *       generadores menores y el sistema no sera minimal;
+ *     - un hijo con menos de g huecos en [1, 2g-1], ya que aadir generadores slo
+ *       quita huecos y un semigrupo de gnero g tiene todos sus huecos en ese intervalo;
+ *     - el resto de candidatos cuando los huecos menores que el candidato, que ya no
+ *       puede cubrir ningn generador posterior, superan g o alguno es mayor o igual
+ *       que 2g (el Frobenius sera al menos 2g).
+ *   Un semigrupo de gnero g es siempre hoja de la bsqueda: cualquier generador ms
+ *   bajara el gnero.
+ */
+void exploraPoda(EstadoPoda& e, int p, int desde) {
+   if (p == e.tamanoMaximo || (p > 0 && p == e.generadores[0]))
+      return;
+   const vector<uint8_t>& actual = e.pertenencia[p];
+   int permanentes = 0;
+   for (int i = 1; i < desde && i <= e.limite; ++i)
+      if (!actual[i])
+         ++permanentes;
+
+   for (int x = desde; x <= e.limite; ++x) {
+      if (permanentes > e.genero) {
+         ++e.contadores.podados;
+         break;
+      }
+      if (actual[x]) {
+         ++e.contadores.podados;
+         continue;
+      }
+
+      ++e.contadores.explorados;
+      anadeGeneradorPoda(e, p, x);
+      if (e.huecos[p + 1] < e.genero)
+         ++e.contadores.podados;
+      else if (!registraSolucionPoda(e, p + 1))
+         exploraPoda(e, p + 1, x + 1);
+      e.generadores.pop_back();
+
+      //x queda como hueco para los candidatos siguientes
+      ++permanentes;
+      if (x >= 2 * e.genero) {
+         ++e.contadores.podados;
+         break;
+      }
+   }
+}
+
+/**
+ * @brief Busca semigrupos de gnero y multiplicidad fijos con una bsqueda recursiva con poda.
+ * @param[in] genero        Gnero objetivo.
+ * @param[in] multiplicidad Mnimo elemento (multiplicidad) de cada semigrupo sin contar el 0.
+ * @param[out] resultado Semigrupos numricos clasificados en internos y hojas.
+ * @param[out] contadores Nodos explorados y podados.
+ * @details
+ *   Recorre los mismos subconjuntos que buscaPorCombinaciones, fijando la multiplicidad
+ *   como primer generador y aadiendo el resto en orden creciente (ver exploraPoda).
+ */
+void buscaPorPoda(int genero, int multiplicidad, ListaSemigrupos& resultado, ContadoresPoda& contadores) {
+   EstadoPoda estado;
+   //Con m = g+1 slo est <g+1, ..., 2g+1>, que se cuenta aparte
+   iniciaPoda(estado, genero, cotaGeneradoresGenero(genero), genero, &resultado);
+   if (multiplicidad <= genero) {
+      ++estado.contadores.explorados;
+      anadeGeneradorPoda(estado, 0, multiplicidad);
+      exploraPoda(estado, 1, multiplicidad + 1);
+   }
+   contadores = estado.contadores;
+
    if(multiplicidad == genero + 1){
       vector<int> semigrupoExtra;
       for (int i = genero + 1; i <= 2 * genero + 1; ++i)
          semigrupoExtra.push_back(i);
-      internos.push_back(semigrupoExtra);
+      anadeSemigrupo(resultado, semigrupoExtra, false);
    }
 
-   cout << "\nSemigrupos numericos internos (m=" << multiplicidad << ", g=" << genero << "):\n";
-   for (const auto& s : internos) {
-      cout << "<";
-      for (size_t i = 0; i < s.size(); ++i)
-         cout << s[i] << (i + 1 < s.size() ? "," : "");
-      cout << ">\n";
+   ordenaLista(resultado);
+}
+
+/**
+ * @brief Estado de la enumeracin por coordenadas de Kunz.
+ * @details
+ *   Con multiplicidad m, el conjunto de Apry respecto a m es {0, w_1, ..., w_{m-1}} con
+ *   w_i = k_im + i y k_i >= 1. El gnero es la suma de las k_i, y un vector (k_i) viene
+ *   de un semigrupo si y solo si cumple las desigualdades de Kunz:
+ *     - k_a + k_b >= k_{a+b}       si a + b < m,
+ *     - k_a + k_b + 1 >= k_{a+b-m} si a + b > m.
+ */
+struct EstadoKunz {
+   int genero = 0;
+   int multiplicidad = 0;
+   vector<int> k;                        //k[i] para 1 <= i < m (k[0] = 0 no se usa)
+   ListaSemigrupos* resultado = nullptr; //nullptr: solo se cuenta en recuento
+   RecuentoSemigrupos recuento;
+   ContadoresPoda contadores;
+};
+
+/**
+ * @brief Guarda (o cuenta, si no hay listas) el semigrupo de coordenadas de Kunz e.k ya completas.
+ * @param[in,out] e Estado de la enumeracin.
+ * @details
+ *   w_i es generador minimal si no es suma de otros dos elementos no nulos de Apry, es
+ *   decir, si las desigualdades de Kunz en las que aparece k_i como trmino derecho son
+ *   todas estrictas. El Frobenius es max(w_i) - m.
+ */
+void registraKunz(EstadoKunz& e) {
+   int m = e.multiplicidad;
+   bool guarda = e.resultado != nullptr;
+   ConjuntoGeneradores generadores;
+   anadeGenerador(generadores, m);
+   int maximo = 0, mayorGenerador = m;
+   for (int i = 1; i < m; ++i) {
+      int w = e.k[i] * m + i;
+      maximo = max(maximo, w);
+      bool minimal = true;
+      for (int a = 1; a < m && minimal; ++a) {
+         int b = i - a;
+         if (b > 0)
+            minimal = e.k[a] + e.k[b] > e.k[i];
+         else if (b < 0)
+            minimal = e.k[a] + e.k[b + m] + 1 > e.k[i];
+      }
+      if (minimal) {
+         mayorGenerador = max(mayorGenerador, w);
+         if (guarda)
+            insertaGenerador(generadores, w);
+      }
    }
 
-   cout << "\nSemigrupos numericos hoja (m=" << multiplicidad << ", g=" << genero << "):\n";
-   for (const auto& h : hojas) {
-      cout << "<";
-      for (size_t i = 0; i < h.size(); ++i)
-         cout << h[i] << (i + 1 < h.size() ? "," : "");
-      cout << ">\n";
+   bool hoja = maximo - m > mayorGenerador;
+   if (!guarda) {
+      ++(hoja ? e.recuento.hojas : e.recuento.internos);
+      return;
+   }
+   anadeSemigrupo(*e.resultado, generadores, hoja);
+}
+
+/**
+ * @brief Asigna la coordenada k_i y desarrolla las siguientes.
+ * @param[in,out] e Estado de la enumeracin.
+ * @param[in] i Coordenada a asignar (las anteriores ya lo estn).
+ * @param[in] restante Gnero que falta por repartir entre k_i, ..., k_{m-1}.
+ * @details
+ *   Cada desigualdad de Kunz se comprueba al asignar su mayor ndice, que es i:
+ *     - k_a + k_b >= k_i con a + b = i da la cota superior min(k_a + k_b);
+ *     - k_i + k_j + 1 >= k_{i+j-m} con j <= i da la cota inferior k_{i+j-m} - k_j - 1
+ *       (o k_{2i-m} / 2 si j = i).
+ *   Adems cada coordenada posterior vale al menos 1, lo que acota k_i por arriba con
+ *   restante - (m-1-i), y la ltima debe agotar el gnero. Un intervalo vaco poda la rama.
+ */
+void exploraKunz(EstadoKunz& e, int i, int restante) {
+   int m = e.multiplicidad;
+   if (i == m) {
+      if (restante == 0)
+         registraKunz(e);
+      return;
+   }
+
+   int inferior = 1;
+   int superior = restante - (m - 1 - i);
+   for (int a = 1; 2 * a <= i; ++a)
+      superior = min(superior, e.k[a] + e.k[i - a]);
+   for (int j = m - i + 1; j <= i; ++j) {
+      int t = i + j - m;
+      if (j == i)
+         inferior = max(inferior, e.k[t] / 2);
+      else
+         inferior = max(inferior, e.k[t] - e.k[j] - 1);
+   }
+   if (i == m - 1)
+      inferior = max(inferior, restante);
+   if (inferior > superior) {
+      ++e.contadores.podados;
+      return;
+   }
+
+   for (int valor = inferior; valor <= superior; ++valor) {
+      ++e.contadores.explorados;
+      e.k[i] = valor;
+      exploraKunz(e, i + 1, restante - valor);
+   }
+}
+
+/**
+ * @brief Busca semigrupos de gnero y multiplicidad fijos como puntos enteros del
+ *        poliedro de Kunz.
+ * @param[in] genero        Gnero objetivo.
+ * @param[in] multiplicidad Mnimo elemento (multiplicidad) de cada semigrupo sin contar el 0.
+ * @param[out] resultado Semigrupos numricos clasificados en internos y hojas.
+ * @param[out] contadores Coordenadas asignadas y ramas podadas.
+ * @details
+ *   Recorre con vuelta atrs las coordenadas k_1, ..., k_{m-1} (ver exploraKunz). Cada
+ *   punto del poliedro con suma g es exactamente un semigrupo de multiplicidad m y
+ *   gnero g, as que no hay ventana de candidatos ni semigrupos descartados al final.
+ */
+void buscaPorKunz(int genero, int multiplicidad, ListaSemigrupos& resultado, ContadoresPoda& contadores) {
+   EstadoKunz estado;
+   estado.genero = genero;
+   estado.multiplicidad = multiplicidad;
+   estado.k.assign(multiplicidad, 0);
+   estado.resultado = &resultado;
+   exploraKunz(estado, 1, genero);
+   contadores = estado.contadores;
+
+   ordenaLista(resultado);
+}
+
+/**
+ * @brief Cuenta los semigrupos de gnero y multiplicidad fijos con el motor de Kunz o el
+ *        de poda, sin guardarlos.
+ * @param[in] genero        Gnero objetivo.
+ * @param[in] multiplicidad Mnimo elemento (multiplicidad) de cada semigrupo sin contar el 0.
+ * @param[in] motor         MotorBusqueda::KUNZ o MotorBusqueda::PODA.
+ * @param[out] recuento     Nmero de semigrupos internos y hoja.
+ * @param[out] contadores   Nodos explorados y podados.
+ * @details
+ *   Los estados se preparan como en buscaPorKunz y buscaPorPoda pero sin listas, de modo
+ *   que cada solucin solo incrementa un contador.
+ */
+void cuentaSemigrupos(int genero, int multiplicidad, MotorBusqueda motor, RecuentoSemigrupos& recuento, ContadoresPoda& contadores) {
+   if (motor == MotorBusqueda::KUNZ) {
+      EstadoKunz estado;
+      estado.genero = genero;
+      estado.multiplicidad = multiplicidad;
+      estado.k.assign(multiplicidad, 0);
+      exploraKunz(estado, 1, genero);
+      recuento = estado.recuento;
+      contadores = estado.contadores;
+      return;
+   }
+
+   EstadoPoda estado;
+   //Con m = g+1 slo est <g+1, ..., 2g+1>, que se cuenta aparte
+   iniciaPoda(estado, genero, cotaGeneradoresGenero(genero), genero, nullptr);
+   if (multiplicidad <= genero) {
+      ++estado.contadores.explorados;
+      anadeGeneradorPoda(estado, 0, multiplicidad);
+      exploraPoda(estado, 1, multiplicidad + 1);
+   }
+   recuento = estado.recuento;
+   contadores = estado.contadores;
+   //<g+1, ..., 2g+1>, que la bsqueda no alcanza por tener g+1 generadores
+   if (multiplicidad == genero + 1)
+      ++recuento.internos;
+}
+
+/**
+ * @brief Estado del recorrido del rbol de semigrupos para todas las multiplicidades.
+ * @details
+ *   descomposiciones[p][i] es el nmero de pares (a, b) con a <= b, a + b = i y a, b en
+ *   el nodo de gnero p de la rama actual (incluido el 0); i pertenece si es no nulo e
+ *   i > 0 es generador minimal si vale 1. Los nodos de gnero p <= g tienen generadores
+ *   hasta cotaGeneradoresGenero(p) <= 2g + 1, as que basta con [0, 2g + 1].
+ */
+struct EstadoArbol {
+   int genero = 0;
+   int limite = 0;                                //mayor entero representado
+   bool guardaListas = false;                     //guardar los semigrupos adems de contarlos
+   vector<vector<uint16_t>> descomposiciones;     //nodo de cada gnero de la rama actual
+   vector<int> multiplicidad;                     //multiplicidad de cada nodo de la rama
+   vector<int> frobenius;                         //Frobenius de cada nodo de la rama
+   vector<uint64_t> internos;                     //internos de gnero g por multiplicidad
+   vector<uint64_t> hojas;                        //hojas de gnero g por multiplicidad
+   vector<ListaSemigrupos> listas;                //semigrupos por multiplicidad
+};
+
+/**
+ * @brief Prepara el recorrido con la raz N = <1> en el nivel 0.
+ * @param[out] e Estado a inicializar.
+ * @param[in] genero Gnero objetivo.
+ * @param[in] guardaListas Si se guardan los semigrupos o solo se cuentan.
+ */
+void iniciaArbol(EstadoArbol& e, int genero, bool guardaListas) {
+   e.genero = genero;
+   e.limite = cotaGeneradoresGenero(genero);
+   e.guardaListas = guardaListas;
+   e.descomposiciones.assign(genero + 1, vector<uint16_t>(e.limite + 1, 0));
+   for (int i = 0; i <= e.limite; ++i)
+      e.descomposiciones[0][i] = (uint16_t)(i / 2 + 1);
+   e.multiplicidad.assign(genero + 1, 1);
+   e.frobenius.assign(genero + 1, -1);
+   e.internos.assign(genero + 2, 0);
+   e.hojas.assign(genero + 2, 0);
+   e.listas.assign(guardaListas ? genero + 2 : 0, ListaSemigrupos());
+}
+
+/**
+ * @brief Recorre en profundidad el subrbol del nodo de gnero p.
+ * @param[in,out] e Estado del recorrido.
+ * @param[in] p Gnero del nodo actual.
+ * @details
+ *   Los hijos de S son S \ {x} para cada generador minimal x > F(S), con
+ *   min(F + m, 2p + 1) como cota de los generadores; al quitar x basta con restar la
+ *   pertenencia de S desplazada x posiciones. Cada semigrupo tiene un nico padre (S unin {F(S)}), as que los de
+ *   gnero g se visitan una sola vez, sea cual sea su multiplicidad, y se anotan en la
+ *   fila de la suya. Es hoja si su mayor generador minimal es menor que su Frobenius.
+ */
+void recorreArbol(EstadoArbol& e, int p) {
+   const vector<uint16_t>& actual = e.descomposiciones[p];
+   int m = e.multiplicidad[p];
+   int frobenius = e.frobenius[p];
+   int cota = max(min(frobenius + m, cotaGeneradoresGenero(p)), 1);
+
+   if (p == e.genero) {
+      int mayor = 0;
+      for (int x = m; x <= cota; ++x)
+         if (actual[x] == 1)
+            mayor = x;
+      bool hoja = mayor < frobenius;
+      if (hoja)
+         ++e.hojas[m];
+      else
+         ++e.internos[m];
+      if (e.guardaListas) {
+         ConjuntoGeneradores generadores;
+         for (int x = m; x <= cota; ++x)
+            if (actual[x] == 1)
+               anadeGenerador(generadores, x);
+         anadeSemigrupo(e.listas[m], generadores, hoja);
+      }
+      return;
    }
 
-   comparaCantidades(internos, hojas);
+   vector<uint16_t>& hijo = e.descomposiciones[p + 1];
+   for (int x = max(frobenius + 1, 1); x <= cota; ++x) {
+      if (actual[x] != 1)
+         continue;
+      hijo = actual;
+      for (int i = x; i <= e.limite; ++i)
+         hijo[i] -= (actual[i - x] != 0);
+      e.frobenius[p + 1] = x;
+      //Si se quita la multiplicidad, el siguiente elemento es x+1 (todo lo mayor que F est en S).
+      e.multiplicidad[p + 1] = (x == m) ? x + 1 : m;
+      recorreArbol(e, p + 1);
+   }
+}
+
+/**
+ * @brief Cuenta, y opcionalmente imprime, los semigrupos de un gnero para todas las
+ *        multiplicidades con un nico recorrido del rbol.
+ * @param[in] genero Gnero objetivo.
+ * @param[in] listas Si se imprimen tambin los semigrupos de cada multiplicidad.
+ * @details
+ *   Una fila completa de la tabla (g, m) cuesta un recorrido en lugar de g + 1
+ *   bsquedas, una por multiplicidad.
+ */
+void encontrarTodasMultiplicidades(int genero, bool listas) {
+   EstadoArbol estado;
+   iniciaArbol(estado, genero, listas);
+   recorreArbol(estado, 0);
+
+   uint64_t totalInternos = 0, totalHojas = 0;
+   cout << "\nSemigrupos numericos de genero " << genero << " por multiplicidad:\n";
+   for (int m = 1; m <= genero + 1; ++m) {
+      cout << "m=" << m << ": internos " << estado.internos[m] << ", hojas " << estado.hojas[m] << "\n";
+      totalInternos += estado.internos[m];
+      totalHojas += estado.hojas[m];
+   }
+   cout << "Total: internos " << totalInternos << ", hojas " << totalHojas << "\n";
+
+   if (!listas)
+      return;
+   for (int m = 1; m <= genero + 1; ++m) {
+      ordenaLista(estado.listas[m]);
+      cout << "\nSemigrupos numericos internos (m=" << m << ", g=" << genero << "):\n";
+      imprimeLista(estado.listas[m], false);
+      cout << "\nSemigrupos numericos hoja (m=" << m << ", g=" << genero << "):\n";
+      imprimeLista(estado.listas[m], true);
+   }
+}
+
+/**
+ * @brief Busca, clasifica e imprime semigrupos numricos de gnero y multiplicidad fijos.
+ * @param[in] genero        Gnero objetivo.
+ * @param[in] multiplicidad Mnimo elemento (multiplicidad) de cada semigrupo sin contar el 0.
+ * @param[in] motor         Motor de bsqueda a emplear.
+ * @details
+ *   Imprime ambos conjuntos y compara sus tamaos; con los motores de Kunz y de poda
+ *   aade adems los nodos explorados y podados.
+ */
+void encontrarSemigruposYHojas(int genero, int multiplicidad, MotorBusqueda motor) {
+   ListaSemigrupos semigrupos;
+   ContadoresPoda contadores;
+
+   if (motor == MotorBusqueda::KUNZ)
+      buscaPorKunz(genero, multiplicidad, semigrupos, contadores);
+   else if (motor == MotorBusqueda::PODA)
+      buscaPorPoda(genero, multiplicidad, semigrupos, contadores);
+   else
+      buscaPorCombinaciones(genero, multiplicidad, semigrupos);
+
+   cout << "\nSemigrupos numericos internos (m=" << multiplicidad << ", g=" << genero << "):\n";
+   imprimeLista(semigrupos, false);
+
+   cout << "\nSemigrupos numericos hoja (m=" << multiplicidad << ", g=" << genero << "):\n";
+   imprimeLista(semigrupos, true);
+
+   comparaCantidades(semigrupos);
+   if (motor != MotorBusqueda::COMBINACIONES)
+      cout << "Nodos explorados: " << contadores.explorados << ", podados: " << contadores.podados << "\n";
+}
+
+/**
+ * @brief Cuenta los semigrupos numricos de gnero y multiplicidad fijos e imprime solo los totales.
+ * @param[in] genero        Gnero objetivo.
+ * @param[in] multiplicidad Mnimo elemento (multiplicidad) de cada semigrupo sin contar el 0.
+ * @param[in] motor         Motor de bsqueda a emplear.
+ * @details
+ *   Ningn motor construye ni imprime los sistemas de generadores.
+ */
+void contarSemigruposYHojas(int genero, int multiplicidad, MotorBusqueda motor) {
+   RecuentoSemigrupos recuento;
+   ContadoresPoda contadores;
+   if (motor == MotorBusqueda::COMBINACIONES)
+      cuentaPorCombinaciones(genero, multiplicidad, recuento);
+   else
+      cuentaSemigrupos(genero, multiplicidad, motor, recuento, contadores);
+
+   cout << "\nSemigrupos numericos internos (m=" << multiplicidad << ", g=" << genero << "): " << recuento.internos << "\n";
+   cout << "Semigrupos numericos hoja (m=" << multiplicidad << ", g=" << genero << "): " << recuento.hojas << "\n";
+   if (motor != MotorBusqueda::COMBINACIONES)
+      cout << "Nodos explorados: " << contadores.explorados << ", podados: " << contadores.podados << "\n";
 }
 
 /**
  * @brief Punto de entrada: valida parmetros y se ejecuta el programa.
+ * @param[in] argc Nmero de argumentos.
+ * @param[in] argv Argumentos; admite --motor=kunz (por defecto), poda o combinaciones,
+ *                 --todas-multiplicidades (con --listas para imprimir los semigrupos),
+ *                 y --solo-contar.
  * @return 0 si xito, 1 si error en entrada.
  */
-int main() {
+int main(int argc, char* argv[]) {
+   MotorBusqueda motor = MotorBusqueda::KUNZ;
+   bool todasMultiplicidades = false;
+   bool listas = false;
+   bool soloContar = false;
+   for (int i = 1; i < argc; ++i) {
+      string opcion = argv[i];
+      if (opcion == "--motor=kunz")
+         motor = MotorBusqueda::KUNZ;
+      else if (opcion == "--motor=poda")
+         motor = MotorBusqueda::PODA;
+      else if (opcion == "--motor=combinaciones")
+         motor = MotorBusqueda::COMBINACIONES;
+      else if (opcion == "--todas-multiplicidades")
+         todasMultiplicidades = true;
+      else if (opcion == "--listas")
+         listas = true;
+      else if (opcion == "--solo-contar")
+         soloContar = true;
+      else {
+         cout << "Opcion no valida: " << opcion << ". Usa --motor=kunz|poda|combinaciones, --todas-multiplicidades, --listas y --solo-contar." << endl;
+         return 1;
+      }
+   }
+
    string inputGenero, inputMultiplicidad;
     
    cout << "Introduce el genero: ";
    getline(cin, inputGenero);
+
+   //Una fila completa de la tabla: no se pide la multiplicidad
+   if (todasMultiplicidades) {
+      if (!regex_match(inputGenero, regex("^[0-9]+$"))) {
+         cout << "Por favor, introduce valores validos (un unico numero entero sin caracteres ni decimales).\n";
+         return 1;
+      }
+      int genero = stoi(inputGenero);
+      cout << "Calculando semigrupos numericos con genero " << genero << " para todas las multiplicidades...\n";
+      auto inicio = chrono::high_resolution_clock::now();
+      encontrarTodasMultiplicidades(genero, listas);
+      auto fin = chrono::high_resolution_clock::now();
+      cout << "\nEl programa tardo " << chrono::duration_cast<chrono::seconds>(fin - inicio).count() << " segundos.\n";
+      return 0;
+   }
     
    cout << "Introduce la multiplicidad: ";
    getline(cin, inputMultiplicidad);
@@ -420,6 +1634,10 @@ int main() {
    }
     
    //Condicin por defecto: si el gnero es 0 y la multiplicidad 1
+   if (genero == 0 && multiplicidad == 1 && soloContar) {
+      cout << "Semigrupos numericos internos: 1\nSemigrupos numericos hoja: 0\n";
+      return 0;
+   }
    if (genero == 0 && multiplicidad == 1) {
       cout << "Semigrupos numericos internos:\n<1>\n\nSemigrupos numericos hoja:\n";
       return 0;
@@ -429,7 +1647,10 @@ int main() {
       << " y multiplicidad " << multiplicidad << "...\n";
     
    auto inicio = chrono::high_resolution_clock::now();
-   encontrarSemigruposYHojas(genero, multiplicidad);
+   if (soloContar)
+      contarSemigruposYHojas(genero, multiplicidad, motor);
+   else
+      encontrarSemigruposYHojas(genero, multiplicidad, motor);
    auto fin = chrono::high_resolution_clock::now();
    auto duracion = chrono::duration_cast<chrono::seconds>(fin - inicio).count();
    
@@ -12,15 +12,14 @@
 #define ALGORITMO_GENERO_MULTIPLICIDAD_FIJA_HPP
 
 #include <vector>
+#include <array>
 #include <string>
 #include <unordered_map>
 #include <set>
+#include <cstdint>
 
 namespace semigrupo {
 
-extern std::unordered_map<std::string, int> cacheGenero;
-extern std::unordered_map<std::string, int> cacheFrobenius;
-
 /**
  * @brief Calcula el mximo comn divisor entre dos enteros.
  * @param a Primer operando.
@@ -30,87 +29,569 @@ extern std::unordered_map<std::string, int> cacheFrobenius;
 int maxCD(int a, int b);
 
 /**
- * @brief Genera una clave ordenada para memoizacin a partir de un vector.
- * @param S Conjunto de generadores.
- * @return Cadena con los elementos de S ordenados y separados por comas.
+ * @brief Nmero de generadores que un ConjuntoGeneradores guarda sin memoria dinmica.
  */
-std::string clave(const std::vector<int>& S);
+const int GENERADORES_EN_LINEA = 32;
 
 /**
- * @brief Calcula el conductor de un semigrupo numrico.
- * @param S Conjunto de generadores.
- * @return El menor n tal que todos los enteros >= n son representables.
+ * @brief Conjunto ordenado de generadores positivos y distintos, con hasta
+ *        GENERADORES_EN_LINEA guardados en lnea (16 bits) y el resto en memoria dinmica.
+ *        Se construye implcitamente desde un std::vector<int> en cualquier orden.
  */
-int calculaConductor(const std::vector<int>& S);
+struct ConjuntoGeneradores {
+    uint16_t enLinea[GENERADORES_EN_LINEA] = {};  //Generadores, si caben.
+    std::vector<uint16_t> desbordados;            //Todos los generadores, si no caben.
+    int tamano = 0;                               //Nmero de generadores.
+
+    ConjuntoGeneradores() {}
+    ConjuntoGeneradores(const std::vector<int>& S);
+
+    const uint16_t* begin() const;
+    const uint16_t* end() const;
+    size_t size() const;
+    bool empty() const;
+    int operator[](size_t i) const;
+    int front() const;
+    int back() const;
+};
 
 /**
- * @brief Calcula el gnero de un semigrupo numrico.
- * @param S Conjunto de generadores.
- * @return Nmero de enteros no representables por S.
+ * @brief Aade un generador mayor que todos los del conjunto.
+ * @param G Conjunto.
+ * @param x Nuevo generador.
  */
-int calculaGenero(const std::vector<int>& S);
+void anadeGenerador(ConjuntoGeneradores& G, int x);
 
 /**
- * @brief Calcula el nmero de Frobenius de un semigrupo generado por S.
- * @param S Conjunto de generadores.
- * @return Mximo entero no representable (o -1 si todos son representables).
+ * @brief Inserta un generador en su posicin, si no estaba ya.
+ * @param G Conjunto.
+ * @param x Generador positivo.
+ */
+void insertaGenerador(ConjuntoGeneradores& G, int x);
+
+/**
+ * @brief Invariantes bsicos de un semigrupo numrico, calculados en una sola pasada.
  */
-int calculaFrobenius(const std::vector<int>& S);
+struct InvariantesSemigrupo {
+    bool finito;            //mcd de los generadores igual a 1 (complemento finito).
+    int multiplicidad;      //Menor generador no nulo.
+    int frobenius;          //Mayor entero no representable (-1 para N).
+    int conductor;          //frobenius + 1.
+    int genero;             //Nmero de enteros no representables.
+    int dimensionEmbebido;  //Nmero de generadores minimales.
+};
+
+/**
+ * @brief Calcula los invariantes a partir de Ap(S, m), con O(m) memoria y sin ventana,
+ *        as que no depende de la cota de Schur (m-1)(M-1).
+ * @param generadores Generadores positivos, distintos, ordenados y con mcd 1.
+ * @param inv Invariantes; se rellenan todos los campos salvo finito.
+ */
+void invariantesPorApery(const ConjuntoGeneradores& generadores, InvariantesSemigrupo& inv);
+
+/**
+ * @brief Conjunto de enteros de [0, 64PALABRAS) guardado como bits de ancho fijo,
+ *        sin reservas de memoria.
+ */
+template <int PALABRAS>
+struct BitsFijos {
+    std::array<uint64_t, PALABRAS> bloques;
+};
+
+/**
+ * @brief Comprueba si i est en el conjunto; los enteros fuera de la ventana se dan por incluidos.
+ * @param R Conjunto.
+ * @param i Entero no negativo.
+ * @return true si i >= 64PALABRAS o su bit est a 1.
+ */
+template <int PALABRAS>
+bool contieneFijo(const BitsFijos<PALABRAS>& R, int i);
+
+/**
+ * @brief Hace R |= R << k dentro de la ventana.
+ * @param R Conjunto.
+ * @param k Desplazamiento (0 < k < 64PALABRAS).
+ */
+template <int PALABRAS>
+void cierraDesplazamientoFijo(BitsFijos<PALABRAS>& R, int k);
+
+/**
+ * @brief Calcula los invariantes sobre una ventana de 64PALABRAS bits.
+ * @param generadores Generadores positivos, distintos, ordenados y con mcd 1.
+ * @param limite Cota de Schur max((m-1)(M-1), M) de los generadores.
+ * @param inv Invariantes; se rellenan todos los campos salvo finito.
+ * @return true si la ventana supera la cota o termina en un bloque de m elementos consecutivos.
+ */
+template <int PALABRAS>
+bool invariantesPorBitsFijos(const ConjuntoGeneradores& generadores, long long limite, InvariantesSemigrupo& inv);
+
+/**
+ * @brief Calcula los invariantes con la menor ventana de bits fija (64 a 1024 bits) que
+ *        supera la cota de Schur, o con la de 1024 si ninguna la supera.
+ * @param generadores Generadores positivos, distintos, ordenados y con mcd 1.
+ * @param inv Invariantes; se rellenan todos los campos salvo finito.
+ * @return true si el resultado es exacto; false si hay que usar invariantesPorApery.
+ */
+bool invariantesPorBits(const ConjuntoGeneradores& generadores, InvariantesSemigrupo& inv);
+
+/**
+ * @brief Calcula todos los invariantes bsicos de un semigrupo en una sola pasada.
+ * @param generadores Conjunto de generadores.
+ * @return Invariantes; finito = false si el mcd no es 1.
+ */
+InvariantesSemigrupo calculaInvariantes(const ConjuntoGeneradores& generadores);
+
+/**
+ * @brief Calcula el sistema minimal sobre una ventana fija de 64PALABRAS bits.
+ * @param generadores Generadores positivos, distintos y ordenados, con el mayor menor
+ *        que 64PALABRAS.
+ * @param minimal Generadores que no son suma de otros, en orden creciente.
+ * @return true si [0, max(generadores)] contiene un bloque de m elementos consecutivos.
+ */
+template <int PALABRAS>
+bool sistemaMinimalFijo(const ConjuntoGeneradores& generadores, ConjuntoGeneradores& minimal);
+
+/**
+ * @brief Calcula el sistema minimal de generadores con una pasada de bits sobre [0, max(S)].
+ * @param generadores Conjunto de generadores.
+ * @param minimal Generadores que no son suma de otros.
+ * @return true si la ventana contiene un bloque de m elementos consecutivos del semigrupo.
+ */
+bool sistemaMinimal(const ConjuntoGeneradores& generadores, ConjuntoGeneradores& minimal);
 
 /**
  * @brief Comprueba si S es minimal en forma expandida de Hilbert.
  * @param S Conjunto de generadores.
- * @return true si ningn generador es redundante y se alcanza un bloque mnimo.
+ * @return true si ningn generador es redundante (dimensin de embebido igual a |S|).
  */
-bool esMinimalHilbert(const std::vector<int>& S);
+bool esMinimalHilbert(const ConjuntoGeneradores& S);
 
 /**
- * @brief Determina si S genera un semigrupo hoja.
- * @param S Conjunto de generadores.
+ * @brief Estado de un recorrido perezoso (orden de puerta giratoria) de las
+ *        combinaciones de tamao fijo, reutilizando un nico bfer.
+ */
+struct IteradorCombinaciones {
+    const std::vector<int>* numeros = nullptr;
+    int tamano = 0;
+    std::vector<int> indices;
+    std::vector<int> combinacion;
+    bool primera = true;
+    bool terminado = false;
+};
+
+/**
+ * @brief Prepara un iterador sobre las combinaciones de `tamano` elementos de `numeros`.
+ * @param it Iterador a inicializar.
+ * @param numeros Vector de entrada; debe seguir vivo mientras se use el iterador.
+ * @param tamano Tamao de cada combinacin.
+ */
+void iniciaCombinaciones(IteradorCombinaciones& it, const std::vector<int>& numeros, int tamano);
+
+/**
+ * @brief Avanza a la siguiente combinacin y la deja en `it.combinacion`.
+ * @param it Iterador de combinaciones.
+ * @return false cuando ya no quedan combinaciones.
+ */
+bool siguienteCombinacion(IteradorCombinaciones& it);
+
+/**
+ * @brief Nmero mximo de candidatos que se evalan juntos en un lote.
+ */
+const int TAMANO_LOTE = 256;
+
+/**
+ * @brief Bloque de candidatos guardado como estructura de arrays: generadores[j][c] es el
+ *        j-simo generador (en orden creciente) del candidato c.
+ */
+struct LoteCandidatos {
+    int cantidad = 0;                                        //Candidatos en el lote.
+    uint8_t tamanos[TAMANO_LOTE];                            //Generadores de cada candidato.
+    uint16_t generadores[GENERADORES_EN_LINEA][TAMANO_LOTE]; //Generadores por posicin.
+};
+
+/**
+ * @brief Resultados de evaluaLote, uno por candidato.
+ */
+struct ResultadosLote {
+    uint8_t mcdUno[TAMANO_LOTE];   //1 si el mcd de los generadores es 1.
+    uint8_t minimal[TAMANO_LOTE];  //1 si el mcd es 1 y ningn generador es suma de los dems.
+    uint8_t hoja[TAMANO_LOTE];     //1 si el mcd es 1 y el Frobenius supera al mayor generador.
+    int genero[TAMANO_LOTE];       //Nmero de huecos, o -1 si el mcd no es 1.
+    int frobenius[TAMANO_LOTE];    //Mayor hueco (-1 para N), o -1 si el mcd no es 1.
+};
+
+/**
+ * @brief Aade un candidato al final de un lote.
+ * @param lote Lote con sitio libre.
+ * @param S Conjunto de 1 a GENERADORES_EN_LINEA generadores.
+ */
+void anadeCandidatoLote(LoteCandidatos& lote, const ConjuntoGeneradores& S);
+
+/**
+ * @brief Reconstruye el conjunto de generadores de un candidato del lote.
+ * @param lote Lote.
+ * @param c ndice del candidato.
+ * @return Sus generadores.
+ */
+ConjuntoGeneradores candidatoDeLote(const LoteCandidatos& lote, int c);
+
+/**
+ * @brief Evala a la vez los candidatos indicados de un lote sobre una ventana de
+ *        64PALABRAS bits, con los conjuntos alcanzables como estructura de arrays.
+ * @param lote Lote.
+ * @param indices Candidatos que se evalan.
+ * @param n Nmero de ndices.
+ * @param r Resultados de los candidatos exactos.
+ * @param exacto exacto[c] = 1 si el resultado de c es vlido en la ventana.
+ */
+template <int PALABRAS>
+void evaluaLoteFijo(const LoteCandidatos& lote, const int* indices, int n, ResultadosLote& r, uint8_t* exacto);
+
+/**
+ * @brief Calcula mcd, gnero, Frobenius, minimalidad y hoja de todos los candidatos de
+ *        un lote, agrupndolos por ventana de bits y recalculando uno a uno los que no
+ *        son exactos en ella.
+ * @param lote Lote de candidatos.
+ * @param r Resultados de cada candidato (ver ResultadosLote).
+ */
+void evaluaLote(const LoteCandidatos& lote, ResultadosLote& r);
+
+/**
+ * @brief Lista compacta de semigrupos en formato CSR (filas comprimidas).
+ * @details
+ *   Los generadores de todos los semigrupos van seguidos en un nico array de 16 bits y
+ *   el semigrupo i ocupa valores[inicios[i]..inicios[i+1]). La clasificacin en hoja o
+ *   interno se guarda en un mapa de bits aparte.
+ */
+struct ListaSemigrupos {
+    std::vector<uint16_t> valores;                               //Generadores de todos los semigrupos, seguidos.
+    std::vector<uint32_t> inicios = std::vector<uint32_t>(1, 0); //Inicio de cada semigrupo y final del ltimo.
+    std::vector<uint64_t> hojas;                                 //Bit i a 1 si el semigrupo i es hoja.
+};
+
+/**
+ * @brief Nmero de semigrupos de una lista.
+ * @param L Lista.
+ * @return Nmero de semigrupos guardados.
+ */
+size_t numSemigrupos(const ListaSemigrupos& L);
+
+/**
+ * @brief Aade un semigrupo al final de una lista.
+ * @param L Lista.
+ * @param generadores Generadores minimales, en el orden en que se guardarn.
+ * @param tamano Nmero de generadores.
+ * @param hoja Si el semigrupo es hoja.
+ */
+void anadeSemigrupo(ListaSemigrupos& L, const uint16_t* generadores, size_t tamano, bool hoja);
+
+/**
+ * @brief Aade un semigrupo al final de una lista.
+ * @param L Lista.
+ * @param S Generadores minimales.
+ * @param hoja Si el semigrupo es hoja.
+ */
+void anadeSemigrupo(ListaSemigrupos& L, const ConjuntoGeneradores& S, bool hoja);
+
+/**
+ * @brief Indica si el semigrupo i de la lista es hoja.
+ * @param L Lista.
+ * @param i ndice del semigrupo.
+ * @return true si es hoja.
+ */
+bool esHojaLista(const ListaSemigrupos& L, size_t i);
+
+/**
+ * @brief Nmero de generadores del semigrupo i de la lista.
+ * @param L Lista.
+ * @param i ndice del semigrupo.
+ * @return Tamao de su sistema minimal.
+ */
+size_t tamanoSemigrupo(const ListaSemigrupos& L, size_t i);
+
+/**
+ * @brief Generadores del semigrupo i de la lista, sin copiarlos.
+ * @param L Lista.
+ * @param i ndice del semigrupo.
+ * @return Puntero a sus tamanoSemigrupo(L, i) generadores.
+ */
+const uint16_t* generadoresSemigrupo(const ListaSemigrupos& L, size_t i);
+
+/**
+ * @brief Cuenta las hojas de una lista.
+ * @param L Lista.
+ * @return Nmero de semigrupos marcados como hoja.
+ */
+uint64_t cuentaHojas(const ListaSemigrupos& L);
+
+/**
+ * @brief Ordena una lista por nmero de generadores y, a igualdad, lexicogrficamente.
+ * @param L Lista; cada semigrupo conserva su clasificacin.
+ */
+void ordenaLista(ListaSemigrupos& L);
+
+/**
+ * @brief Imprime, uno por lnea como <a,b,...>, los semigrupos de la lista de una clase.
+ * @param L Lista.
+ * @param hojas true para imprimir las hojas y false para los internos.
+ */
+void imprimeLista(const ListaSemigrupos& L, bool hojas);
+
+/**
+ * @brief Compara la cantidad de semigrupos internos y hojas.
+ * @param semigrupos Lista de semigrupos clasificados en internos y hojas.
+ */
+void comparaCantidades(const ListaSemigrupos& semigrupos);
+
+/**
+ * @brief Motor de bsqueda empleado para enumerar los semigrupos de gnero y multiplicidad fijos.
+ */
+enum class MotorBusqueda {
+    KUNZ,          //Puntos enteros del poliedro de Kunz.
+    PODA,          //Bsqueda recursiva con poda.
+    COMBINACIONES  //Bsqueda exhaustiva sobre subconjuntos de {m,...,2gnero+1}.
+};
+
+/**
+ * @brief Cota de los generadores minimales de cualquier semigrupo de gnero g.
+ * @param genero Gnero.
+ * @return 2g + 1.
+ */
+int cotaGeneradoresGenero(int genero);
+
+/**
+ * @brief Nmero de semigrupos internos y hoja encontrados, sin guardarlos.
+ */
+struct RecuentoSemigrupos {
+    uint64_t internos = 0;
+    uint64_t hojas = 0;
+};
+
+/**
+ * @brief Prueba en lotes los subconjuntos con la multiplicidad dada y guarda o cuenta
+ *        los semigrupos del gnero, salvo <g+1, ..., 2g+1>.
+ * @param genero        Gnero objetivo.
+ * @param multiplicidad Mnimo elemento del semigrupo (multiplicidad).
+ * @param resultado     Lista donde se guardan los semigrupos, o nullptr para solo contarlos.
+ * @param recuento      Internos y hojas acumulados cuando resultado es nullptr.
+ */
+void exploraCombinaciones(
+    int genero,
+    int multiplicidad,
+    ListaSemigrupos* resultado,
+    RecuentoSemigrupos& recuento
+);
+
+/**
+ * @brief Busca semigrupos de gnero y multiplicidad fijos probando subconjuntos.
+ * @param genero        Gnero objetivo.
+ * @param multiplicidad Mnimo elemento del semigrupo (multiplicidad).
+ * @param resultado     Semigrupos numricos clasificados en internos y hojas.
+ */
+void buscaPorCombinaciones(
+    int genero,
+    int multiplicidad,
+    ListaSemigrupos& resultado
+);
+
+/**
+ * @brief Cuenta los semigrupos de gnero y multiplicidad fijos probando subconjuntos, sin guardarlos.
+ * @param genero        Gnero objetivo.
+ * @param multiplicidad Mnimo elemento del semigrupo (multiplicidad).
+ * @param recuento      Nmero de semigrupos internos y hoja.
+ */
+void cuentaPorCombinaciones(int genero, int multiplicidad, RecuentoSemigrupos& recuento);
+
+/**
+ * @brief Contadores del motor de bsqueda con poda.
+ */
+struct ContadoresPoda {
+    uint64_t explorados = 0; //subconjuntos parciales construidos
+    uint64_t podados = 0;    //ramas descartadas sin desarrollarlas
+};
+
+/**
+ * @brief Estado de la bsqueda recursiva con poda: conjunto alcanzable (truncado a
+ *        [0, alcance]) y nmero de huecos en [1, 2g-1] para cada profundidad.
+ */
+struct EstadoPoda {
+    int genero = 0;
+    int limite = 0;
+    int alcance = 0;
+    int tamanoMaximo = 0;
+    std::vector<std::vector<uint8_t>> pertenencia;
+    std::vector<int> huecos;
+    std::vector<int> generadores;
+    ListaSemigrupos* resultado = nullptr; //nullptr: solo se cuenta en recuento
+    RecuentoSemigrupos recuento;
+    ContadoresPoda contadores;
+};
+
+/**
+ * @brief Prepara el estado de la bsqueda con poda.
+ * @param e Estado a inicializar.
  * @param genero Gnero objetivo.
- * @return true si S genera el gnero dado y su Frobenius supera al mximo generador.
+ * @param limite Mayor candidato a generador (cotaGeneradoresGenero).
+ * @param tamanoMaximo Nmero mximo de generadores.
+ * @param resultado Lista donde se guardan los semigrupos, o nullptr para solo contarlos.
  */
-bool esHoja(const std::vector<int>& S, int genero);
+void iniciaPoda(EstadoPoda& e, int genero, int limite, int tamanoMaximo, ListaSemigrupos* resultado);
 
 /**
- * @brief Genera recursivamente todas las combinaciones de longitud fija.
- * @param subconjuntos Acumula las combinaciones generadas.
- * @param combinacion Vector auxiliar para la combinacin actual.
- * @param numeros Conjunto de nmeros candidatos.
- * @param comienzo ndice desde el que aadir en esta llamada.
- * @param tamano Longitud deseada de cada combinacin.
+ * @brief Aade el generador x al conjunto de la profundidad p y deja el resultado en p+1.
+ * @param e Estado de la bsqueda.
+ * @param p Profundidad actual.
+ * @param x Nuevo generador, mayor que todos los anteriores.
  */
-void generaCombinaciones(
-    std::vector<std::vector<int>>& subconjuntos,
-    std::vector<int>& combinacion,
-    const std::vector<int>& numeros,
-    int comienzo,
-    int tamano
+void anadeGeneradorPoda(EstadoPoda& e, int p, int x);
+
+/**
+ * @brief Guarda el conjunto de la profundidad p si ya es un semigrupo del gnero pedido.
+ * @param e Estado de la bsqueda.
+ * @param p Profundidad actual.
+ * @return true si se ha guardado.
+ */
+bool registraSolucionPoda(EstadoPoda& e, int p);
+
+/**
+ * @brief Desarrolla la rama actual con generadores mayores o iguales que desde, podando
+ *        ramas con m generadores, candidatos representables, ramas con menos de g huecos en [1, 2g-1] y ramas
+ *        con ms de g huecos permanentes o alguno mayor o igual que 2g.
+ * @param e Estado de la bsqueda.
+ * @param p Profundidad actual.
+ * @param desde Menor candidato admisible.
+ */
+void exploraPoda(EstadoPoda& e, int p, int desde);
+
+/**
+ * @brief Busca semigrupos de gnero y multiplicidad fijos con una bsqueda recursiva
+ *        con poda que fija la multiplicidad como primer generador.
+ * @param genero        Gnero objetivo.
+ * @param multiplicidad Mnimo elemento del semigrupo (multiplicidad).
+ * @param resultado     Semigrupos numricos clasificados en internos y hojas.
+ * @param contadores    Nodos explorados y podados.
+ */
+void buscaPorPoda(
+    int genero,
+    int multiplicidad,
+    ListaSemigrupos& resultado,
+    ContadoresPoda& contadores
 );
 
 /**
- * @brief Comprueba si los elementos de S son globalmente coprimos.
- * @param S Conjunto de generadores.
- * @return true si el mcd acumulado termina en 1.
+ * @brief Estado de la enumeracin por coordenadas de Kunz: w_i = k_im + i es el menor
+ *        elemento congruente con i mdulo m, con k_i >= 1 y suma de las k_i igual al gnero.
  */
-bool mcdEsUno(const std::vector<int>& S);
+struct EstadoKunz {
+    int genero = 0;
+    int multiplicidad = 0;
+    std::vector<int> k;
+    ListaSemigrupos* resultado = nullptr; //nullptr: solo se cuenta en recuento
+    RecuentoSemigrupos recuento;
+    ContadoresPoda contadores;
+};
 
 /**
- * @brief Compara la cantidad de semigrupos internos y hojas.
- * @param internos Lista de semigrupos numricos internos.
- * @param hojas    Lista de semigrupos numricos hoja.
+ * @brief Guarda (o cuenta) el semigrupo de coordenadas de Kunz ya completas, con sus generadores
+ *        minimales (los w_i que no son suma de otros dos elementos de Apry).
+ * @param e Estado de la enumeracin.
+ */
+void registraKunz(EstadoKunz& e);
+
+/**
+ * @brief Asigna k_i dentro del intervalo que permiten las desigualdades de Kunz con
+ *        ndices menores y el gnero restante, y desarrolla las coordenadas siguientes.
+ * @param e Estado de la enumeracin.
+ * @param i Coordenada a asignar.
+ * @param restante Gnero que falta por repartir entre k_i, ..., k_{m-1}.
  */
-void comparaCantidades(
-    const std::vector<std::vector<int>>& internos,
-    const std::vector<std::vector<int>>& hojas
+void exploraKunz(EstadoKunz& e, int i, int restante);
+
+/**
+ * @brief Busca semigrupos de gnero y multiplicidad fijos como puntos enteros del
+ *        poliedro de Kunz, sin ventana de candidatos.
+ * @param genero        Gnero objetivo.
+ * @param multiplicidad Mnimo elemento del semigrupo (multiplicidad).
+ * @param resultado     Semigrupos numricos clasificados en internos y hojas.
+ * @param contadores    Coordenadas asignadas y ramas podadas.
+ */
+void buscaPorKunz(
+    int genero,
+    int multiplicidad,
+    ListaSemigrupos& resultado,
+    ContadoresPoda& contadores
 );
 
 /**
- * @brief Busca y clasifica semigrupos numricos de gnero y multiplicidad fijos.
+ * @brief Cuenta los semigrupos de gnero y multiplicidad fijos con el motor de Kunz o el
+ *        de poda, sin guardarlos.
+ * @param genero        Gnero objetivo.
+ * @param multiplicidad Mnimo elemento del semigrupo (multiplicidad).
+ * @param motor         MotorBusqueda::KUNZ o MotorBusqueda::PODA.
+ * @param recuento      Nmero de semigrupos internos y hoja.
+ * @param contadores    Nodos explorados y podados.
+ */
+void cuentaSemigrupos(int genero, int multiplicidad, MotorBusqueda motor,
+                      RecuentoSemigrupos& recuento, ContadoresPoda& contadores);
+
+/**
+ * @brief Estado del recorrido del rbol de semigrupos para todas las multiplicidades:
+ *        descomposiciones de cada nodo de la rama actual sobre [0, 2g + 1] y recuentos
+ *        (y listas, si se piden) de gnero g por multiplicidad.
+ */
+struct EstadoArbol {
+    int genero = 0;
+    int limite = 0;
+    bool guardaListas = false;
+    std::vector<std::vector<uint16_t>> descomposiciones;
+    std::vector<int> multiplicidad;
+    std::vector<int> frobenius;
+    std::vector<uint64_t> internos;
+    std::vector<uint64_t> hojas;
+    std::vector<ListaSemigrupos> listas;
+};
+
+/**
+ * @brief Prepara el recorrido con la raz N = <1> en el nivel 0.
+ * @param e Estado a inicializar.
+ * @param genero Gnero objetivo.
+ * @param guardaListas Si se guardan los semigrupos o solo se cuentan.
+ */
+void iniciaArbol(EstadoArbol& e, int genero, bool guardaListas);
+
+/**
+ * @brief Recorre en profundidad el subrbol del nodo de gnero p (hijos S \ {x} con x
+ *        generador minimal mayor que el Frobenius) y anota cada semigrupo de gnero g
+ *        en la fila de su multiplicidad.
+ * @param e Estado del recorrido.
+ * @param p Gnero del nodo actual.
+ */
+void recorreArbol(EstadoArbol& e, int p);
+
+/**
+ * @brief Cuenta, y opcionalmente imprime, los semigrupos de un gnero para todas las
+ *        multiplicidades con un nico recorrido del rbol.
+ * @param genero Gnero objetivo.
+ * @param listas Si se imprimen tambin los semigrupos de cada multiplicidad.
+ */
+void encontrarTodasMultiplicidades(int genero, bool listas);
+
+/**
+ * @brief Busca, clasifica e imprime semigrupos numricos de gnero y multiplicidad fijos.
+ * @param genero        Gnero objetivo.
+ * @param multiplicidad Mnimo elemento del semigrupo (multiplicidad).
+ * @param motor         Motor de bsqueda a emplear.
+ */
+void encontrarSemigruposYHojas(int genero, int multiplicidad, MotorBusqueda motor);
+
+/**
+ * @brief Cuenta los semigrupos de gnero y multiplicidad fijos e imprime solo los totales,
+ *        sin construir ni imprimir las listas.
  * @param genero        Gnero objetivo.
  * @param multiplicidad Mnimo elemento del semigrupo (multiplicidad).
+ * @param motor         Motor de bsqueda a emplear.
  */
-void encontrarSemigruposYHojas(int genero, int multiplicidad);
+void contarSemigruposYHojas(int genero, int multiplicidad, MotorBusqueda motor);
 
 } 
 